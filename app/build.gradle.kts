@@ -31,6 +31,10 @@ android {
             )
         }
     }
+    androidResources {
+        // Stored entries can be memory-mapped by the native asset loader instead of inflated
+        noCompress += listOf("wav", "mp3")
+    }
     externalNativeBuild {
         cmake {
             // Path to your CMakeLists.txt file - Correct syntax for Kotlin DSL
@@ -3,8 +3,21 @@
 #include <vector>
 #include <memory>
 #include <atomic>
-#include <cmath> // For std::fabs, fmodf, floor, std::cyl_bessel_i (potentially with C++17, but provide fallback)
+#include <cmath> // For std::fabs, std::llround, std::ceil, std::cyl_bessel_i (potentially with C++17, but provide fallback)
 #include <algorithm> // For std::clamp, std::min, std::transform, std::max
+#include <thread>
+#include <chrono>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <list>
+#include <unordered_map>
+#include <type_traits>
+#include <cerrno>
+#include <cstring> // For std::memmove
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <unistd.h>
 #include <android/log.h>
 
 // Define M_PI if not already defined (common in cmath but not guaranteed by standard before C++20)
@@ -13,9 +26,124 @@
 #endif
 
 // Sinc Interpolation Parameters
-constexpr int NUM_TAPS = 16; // Number of points for interpolation
-constexpr int SUBDIVISION_STEPS = 1024; // Number of fractional offsets to pre-calculate
+constexpr int NUM_TAPS = 16; // Number of points for interpolation (default tier, and the base width of the anti-aliasing banks)
+constexpr int SUBDIVISION_STEPS = 128; // Number of fractional offsets to pre-calculate (linearly interpolated between)
 constexpr double KAISER_BETA = 6.0;
+// Interpolation quality tiers. Each AudioSample picks one at load and getAudio runs a kernel
+// specialized for that tap count, so the loop bounds are known to the compiler. Shorter windows
+// get a smaller Kaiser beta to keep their passband usable.
+enum class InterpolationQuality : int { Taps4 = 0, Taps8, Taps16, Taps32, Taps64 };
+constexpr int NUM_QUALITY_TIERS = 5;
+constexpr int QUALITY_TIER_TAPS[NUM_QUALITY_TIERS] = {4, 8, 16, 32, 64};
+constexpr double QUALITY_TIER_BETA[NUM_QUALITY_TIERS] = {3.0, 4.5, KAISER_BETA, 7.5, 9.0};
+constexpr InterpolationQuality PLATTER_INTERPOLATION_QUALITY = InterpolationQuality::Taps32;
+constexpr InterpolationQuality MUSIC_INTERPOLATION_QUALITY = InterpolationQuality::Taps8;
+// Kernel shape. LinearPhase centres the window on the playhead: no group delay, but the kernel reads
+// taps/2 frames ahead and pre-rings on transients. LowDelay moves the peak towards the end of the
+// window (LOW_DELAY_LOOKAHEAD_DIVISOR of it left ahead) with an asymmetric Kaiser window, halving
+// the lookahead and the pre-ringing. Platter samples are read from memory, where lookahead costs
+// no latency (see the group delay logged by logKernelLatency), so linear phase stays the default.
+enum class KernelShape { LinearPhase, LowDelay };
+constexpr int LOW_DELAY_LOOKAHEAD_DIVISOR = 4;
+constexpr KernelShape PLATTER_KERNEL_SHAPE = KernelShape::LinearPhase;
+// Low-power interpolation: a 4-tap Catmull-Rom cubic in place of the sinc tier. The engine moves
+// every voice to it while the device is in power-saving mode or LOW_POWER_VOICE_THRESHOLD voices
+// are playing, crossfading between the two interpolators over INTERPOLATION_CROSSFADE_FRAMES.
+enum class InterpolationMode { Sinc, CatmullRom };
+constexpr int LOW_POWER_VOICE_THRESHOLD = 16;
+constexpr int32_t INTERPOLATION_CROSSFADE_FRAMES = 256;
+// Anti-aliasing banks used when |rate| > 1. Each bank widens the kernel and lowers the cutoff by its
+// scale, so reading the source faster than real time does not fold content above the output Nyquist.
+// A rate uses the smallest bank whose scale covers it; the coefficients are generated at compile time (see SINC_TABLES).
+constexpr int NUM_ANTI_ALIAS_BANKS = 6;
+constexpr float ANTI_ALIAS_BANK_SCALES[NUM_ANTI_ALIAS_BANKS] = {1.5f, 2.0f, 3.0f, 4.0f, 6.0f, 8.0f};
+constexpr int ANTI_ALIAS_PHASES = 64; // Stretched kernels are smoother, so they need fewer phases
+constexpr int MAX_KERNEL_TAPS = NUM_TAPS * 8;
+constexpr float MAX_SCRATCH_RATE = 8.0f; // Scratch rate clamp; matches the widest bank
+// Mipmap pyramid: half-band-decimated copies of platter samples at 1/2, 1/4 and 1/8 of the rate.
+// At high scratch speeds getAudio reads the level whose rate brings |rate| back to <= 1, so the
+// voice's own (narrow) kernel stays alias-free. Costs at most 0.875x extra memory per sample.
+constexpr int MIPMAP_LEVELS = 3;
+constexpr int HALF_BAND_TAPS = 32;
+constexpr bool BUILD_PLATTER_MIPMAPS = true;
+// Source sample rate handling. The source/stream rate ratio is always folded into the playback
+// increment; optionally a sample is instead converted to the stream rate once at load (long kernel)
+// so unity-rate playback keeps its copy fast path. Progressive chunks convert on the decoding
+// thread; a large range decoded at once (a parallel MP3 segment) is spread over worker threads.
+// Music tracks are long and would stall the load, so they are resampled on the fly.
+constexpr bool CONVERT_PLATTER_SAMPLE_RATE_ON_LOAD = true;
+constexpr bool CONVERT_MUSIC_SAMPLE_RATE_ON_LOAD = false;
+constexpr int SAMPLE_RATE_CONVERSION_TAPS = 64; // Widened in proportion when converting down
+constexpr int SAMPLE_RATE_CONVERSION_PHASES = 1024;
+constexpr double SAMPLE_RATE_CONVERSION_BETA = 9.0;
+constexpr unsigned MAX_SAMPLE_RATE_CONVERSION_THREADS = 4;
+// Progressive loading: load() decodes (and converts) only the first PROGRESSIVE_DECODE_SYNC_MS of a
+// sample before returning, so the first sound does not wait on the sample's length. A background
+// thread fills in the rest PROGRESSIVE_DECODE_CHUNK_FRAMES source frames at a time, and voices read
+// no further than the decoded watermark.
+constexpr int PROGRESSIVE_DECODE_SYNC_MS = 250;
+constexpr int32_t PROGRESSIVE_DECODE_CHUNK_FRAMES = 16384;
+// The background thread's long passes (a conversion, a mipmap level) check for cancellation every
+// this many frames, so replacing or freeing a sample never waits for a whole pass
+constexpr int32_t FINISHER_CANCEL_CHECK_FRAMES = 4096;
+// Parallel MP3 decoding: the background part of a progressive load splits what is left of an MP3
+// at frame boundaries (from drmp3_calculate_seek_points) and decodes the pieces on up to
+// MAX_PARALLEL_DECODE_THREADS threads. Each piece starts MP3_SEAM_PREROLL_FRAMES MP3 frames early
+// and discards them, which refills the bit reservoir and primes the synthesis filters.
+constexpr unsigned MAX_PARALLEL_DECODE_THREADS = 4;
+constexpr int32_t MIN_PARALLEL_DECODE_SEGMENT_FRAMES = 131072;
+constexpr int MP3_SEAM_PREROLL_FRAMES = 16;
+constexpr uint32_t MP3_SEEK_POINTS = 256;
+// Playhead format: signed 32.32 fixed point. The integer frame and the kernel phase come straight
+// from the bits, and precision does not degrade with track length the way a float frame count does.
+constexpr int PLAYHEAD_FRACTION_BITS = 32;
+constexpr int64_t PLAYHEAD_ONE = int64_t(1) << PLAYHEAD_FRACTION_BITS;
+inline int64_t playheadFromFrames(double frames) { return static_cast<int64_t>(std::llround(frames * static_cast<double>(PLAYHEAD_ONE))); }
+inline double playheadToFrames(int64_t playhead) { return static_cast<double>(playhead) / static_cast<double>(PLAYHEAD_ONE); }
+// Frames of padding stored before and after the decoded PCM so the kernel never has to wrap or clamp.
+constexpr int GUARD_FRAMES = MAX_KERNEL_TAPS;
+// Loop seam: 4 * GUARD_FRAMES frames around the loop point (the last 2 guards' worth, then the
+// first), so a looping voice can read across the wrap while the shared guards stay silent.
+constexpr int LOOP_SEAM_FRAMES = 4 * GUARD_FRAMES;
+
+// Voice pool: every voice is preallocated, so starting or stopping one never allocates or locks.
+constexpr int MAX_VOICES = 48;
+// Control changes queued from JNI threads to the callback (see EngineCommand). A callback drains
+// everything queued since the last one, so this only needs to cover a burst of UI events.
+constexpr size_t COMMAND_QUEUE_CAPACITY = 256;
+// Decoded samples stay cached after their voices move on, up to this many bytes of PCM (mipmaps
+// and seams included), so cycling back to a recent sample skips the decode. Least recently used
+// entries go first. Adjustable at run time (setSampleCacheBudget).
+constexpr size_t SAMPLE_CACHE_BYTE_BUDGET = 96u * 1024u * 1024u;
+// Prefetch: while idle, the loader decodes the platter samples and music tracks that come after
+// the current one (and optionally the one before) into the sample cache, so the next/previous
+// buttons find them already decoded. A prefetch only goes into room the cache has free and never
+// evicts anything. Adjustable at run time (setPrefetchDepth).
+constexpr int DEFAULT_PREFETCH_DEPTH = 1;
+constexpr bool DEFAULT_PREFETCH_PREVIOUS = true;
+// Music streaming: tracks are decoded on a per-track thread a few hundred milliseconds ahead of the
+// playhead instead of whole into RAM (see StreamingSource), so they are not cached or prefetched.
+constexpr bool STREAM_MUSIC_TRACKS = true;
+constexpr int32_t STREAM_RING_FRAMES = 32768;          // Power of two; ~680 ms at 48 kHz
+constexpr int32_t STREAM_DECODE_AHEAD_FRAMES = 16384;  // Queued frames the producer keeps topped up (~340 ms)
+constexpr int32_t STREAM_DECODE_CHUNK_FRAMES = 2048;
+constexpr int32_t STREAM_WINDOW_FRAMES = 8192;         // Planar window the music voice's kernels read from
+constexpr int STREAM_PRODUCER_POLL_MS = 5;
+// In-place WAV playback: a WAV of 16-bit or float PCM that needs no rate conversion is not decoded.
+// Voices read its data chunk straight out of the asset's mapping (see AudioSample::DirectSource)
+// with kernels specialized for each sample format. The chunk is faulted in and locked on the
+// loader thread so the callback never waits on the disk; a WAV that cannot be locked is decoded.
+// Locked pages count against RLIMIT_MEMLOCK, often only 64 KB for an app, so in practice this
+// covers short one-shots unless the limit has been raised.
+enum class SampleFormat { PlanarFloat, InterleavedFloat, InterleavedInt16, PlanarInt16 };
+constexpr int NUM_SAMPLE_FORMATS = 4;
+constexpr bool PLAY_WAV_IN_PLACE = true;
+// 16-bit storage: a decoded sample can be kept as planar int16 instead of float (see
+// AudioSample::audioData16), half the memory and half the cache lines per kernel window. The
+// kernels widen it to float as they load it. Mipmap levels and loop seams stay float. Music is
+// streamed by default, so this matters most for the platter, which jumps around its sample.
+constexpr bool STORE_PLATTER_SAMPLES_AS_INT16 = true;
+constexpr bool STORE_MUSIC_SAMPLES_AS_INT16 = false;
 #include <android/asset_manager_jni.h> // For AAssetManager_fromJava
 #include <oboe/Oboe.h>
 #include <oboe/Utilities.h> // For oboe::convertToText
@@ -31,172 +159,1038 @@ constexpr double KAISER_BETA = 6.0;
 #define ALOGW(...) __android_log_print(ANDROID_LOG_WARN, APP_TAG, __VA_ARGS__)
 #define ALOGV(...) __android_log_print(ANDROID_LOG_VERBOSE, APP_TAG, __VA_ARGS__)
 
-class AudioEngine;
-
-struct AudioSample {
-    std::string filePath;
-    std::vector<float> audioData;
-    int32_t totalFrames = 0;
-    int32_t channels = 0;
-    uint32_t sampleRate = 0;
-    std::atomic<bool> isPlaying{false};
-    std::atomic<bool> loop{false};
-    bool playOnceThenLoopSilently = false;
-    bool playedOnce = false;
-    std::atomic<float> preciseCurrentFrame{0.0f};
-    AudioEngine* audioEnginePtr = nullptr;
-    std::atomic<bool> useEngineRateForPlayback_{false};
+// SIMD backend selection for the interpolation kernel.
+// arm64 always has NEON (with FMA and horizontal adds); x86_64 (emulator builds) always
+// has SSE, and AVX/FMA when the compiler is allowed to use them. Anything else, including
+// 32-bit ARM, falls through to the scalar loop.
+#if defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define SCRATCH_SIMD_NEON 1
+#elif defined(__AVX__) || defined(__SSE__) || defined(_M_X64)
+#include <immintrin.h>
+#define SCRATCH_SIMD_X86 1
+#endif
 
-    // Sinc table
-    static std::vector<std::vector<float>> sincTable;
-    static bool sincTableInitialized;
-    static void precalculateSincTable();
-    static double bessel_i0_approx(double x);
-    static double kaiserWindow(double n_rel, double N_total_taps, double beta);
+// Dot product of contiguous samples with sinc coefficients. With TAPS > 0 the length is a
+// compile-time constant and the loops fully unroll; TAPS == 0 takes numTaps at run time.
+// The length must be a multiple of 4. Neither pointer needs to be aligned.
+// Independent accumulators keep the FMA pipes busy.
+template <int TAPS = 0>
+static inline float convolveTaps(const float* samples, const float* coeffs, int numTaps = TAPS) {
+    static_assert(TAPS % 4 == 0, "SIMD kernel assumes a multiple of 4 taps");
+    const int n = TAPS > 0 ? TAPS : numTaps;
+    int k = 0;
+#if defined(SCRATCH_SIMD_NEON)
+    float32x4_t acc0 = vdupq_n_f32(0.0f);
+    float32x4_t acc1 = vdupq_n_f32(0.0f);
+    for (; k + 8 <= n; k += 8) {
+        acc0 = vfmaq_f32(acc0, vld1q_f32(samples + k), vld1q_f32(coeffs + k));
+        acc1 = vfmaq_f32(acc1, vld1q_f32(samples + k + 4), vld1q_f32(coeffs + k + 4));
+    }
+    if (k < n) acc0 = vfmaq_f32(acc0, vld1q_f32(samples + k), vld1q_f32(coeffs + k));
+    return vaddvq_f32(vaddq_f32(acc0, acc1));
+#elif defined(SCRATCH_SIMD_X86) && defined(__AVX__)
+    __m256 acc = _mm256_setzero_ps();
+    for (; k + 8 <= n; k += 8) {
+#if defined(__FMA__)
+        acc = _mm256_fmadd_ps(_mm256_loadu_ps(samples + k), _mm256_loadu_ps(coeffs + k), acc);
+#else
+        acc = _mm256_add_ps(acc, _mm256_mul_ps(_mm256_loadu_ps(samples + k), _mm256_loadu_ps(coeffs + k)));
+#endif
+    }
+    __m128 sum4 = _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+    if (k < n) sum4 = _mm_add_ps(sum4, _mm_mul_ps(_mm_loadu_ps(samples + k), _mm_loadu_ps(coeffs + k)));
+    sum4 = _mm_add_ps(sum4, _mm_movehl_ps(sum4, sum4));
+    sum4 = _mm_add_ss(sum4, _mm_shuffle_ps(sum4, sum4, 0x55));
+    return _mm_cvtss_f32(sum4);
+#elif defined(SCRATCH_SIMD_X86)
+    __m128 acc0 = _mm_setzero_ps();
+    __m128 acc1 = _mm_setzero_ps();
+    for (; k + 8 <= n; k += 8) {
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(samples + k), _mm_loadu_ps(coeffs + k)));
+        acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(samples + k + 4), _mm_loadu_ps(coeffs + k + 4)));
+    }
+    if (k < n) acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(samples + k), _mm_loadu_ps(coeffs + k)));
+    __m128 sum4 = _mm_add_ps(acc0, acc1);
+    sum4 = _mm_add_ps(sum4, _mm_movehl_ps(sum4, sum4));
+    sum4 = _mm_add_ss(sum4, _mm_shuffle_ps(sum4, sum4, 0x55));
+    return _mm_cvtss_f32(sum4);
+#else
+    float acc = 0.0f;
+    for (; k < n; ++k) {
+        acc += samples[k] * coeffs[k];
+    }
+    return acc;
+#endif
+}
 
+// Four consecutive frames of channel CHANNEL of PCM with STRIDE samples per frame, as floats.
+// int16 is widened but not scaled. 'frames' points at the first frame, not at the channel.
+#if defined(SCRATCH_SIMD_NEON)
+template <int STRIDE, int CHANNEL>
+static inline float32x4_t loadFrames4(const float* frames) {
+    if constexpr (STRIDE == 1) return vld1q_f32(frames);
+    else return vld2q_f32(frames).val[CHANNEL];
+}
+template <int STRIDE, int CHANNEL>
+static inline float32x4_t loadFrames4(const int16_t* frames) {
+    if constexpr (STRIDE == 1) return vcvtq_f32_s32(vmovl_s16(vld1_s16(frames)));
+    else return vcvtq_f32_s32(vmovl_s16(vld2_s16(frames).val[CHANNEL]));
+}
+#elif defined(SCRATCH_SIMD_X86)
+template <int STRIDE, int CHANNEL>
+static inline __m128 loadFrames4(const float* frames) {
+    if constexpr (STRIDE == 1) return _mm_loadu_ps(frames);
+    else {
+        const __m128 a = _mm_loadu_ps(frames);
+        const __m128 b = _mm_loadu_ps(frames + 4);
+        return CHANNEL == 0 ? _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)) : _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+    }
+}
+template <int STRIDE, int CHANNEL>
+static inline __m128 loadFrames4(const int16_t* frames) {
+    __m128i wide;
+    if constexpr (STRIDE == 1) {
+        const __m128i x = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(frames));
+        wide = _mm_srai_epi32(_mm_unpacklo_epi16(x, x), 16); // Sign extension without SSE4.1
+    } else {
+        const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(frames));
+        wide = CHANNEL == 0 ? _mm_srai_epi32(_mm_slli_epi32(x, 16), 16) : _mm_srai_epi32(x, 16);
+    }
+    return _mm_cvtepi32_ps(wide);
+}
+#endif
 
-    bool hasExtension(const std::string& path, const std::string& extension);
-    bool tryLoadPath(AAssetManager* assetManager, const std::string& currentPathToTry);
-    void load(AAssetManager* assetManager, const std::string& basePath, AudioEngine* engine);
-    void getAudio(float* outputBuffer, int32_t numOutputFrames, int32_t outputStreamChannels, float effectiveVolume);
+// convolveTaps over channel CHANNEL of interleaved (STRIDE samples per frame) float or int16 PCM,
+// read in place. Samples are widened to float as they are loaded and summed in the same order as
+// convolveTaps, so a window gives the same result however it is stored; int16 sums are scaled by
+// 1/32768 at the end, which is exact for a power of two.
+template <int TAPS, int STRIDE, int CHANNEL, typename T>
+static inline float convolveFrameTaps(const T* frames, const float* coeffs, int numTaps = TAPS) {
+    static_assert(TAPS % 4 == 0, "SIMD kernel assumes a multiple of 4 taps");
+    static_assert(STRIDE == 1 || STRIDE == 2, "Interleaved kernels cover mono and stereo");
+    constexpr float scale = std::is_same_v<T, int16_t> ? 1.0f / 32768.0f : 1.0f;
+    const int n = TAPS > 0 ? TAPS : numTaps;
+    int k = 0;
+#if defined(SCRATCH_SIMD_NEON)
+    float32x4_t acc0 = vdupq_n_f32(0.0f);
+    float32x4_t acc1 = vdupq_n_f32(0.0f);
+    for (; k + 8 <= n; k += 8) {
+        acc0 = vfmaq_f32(acc0, loadFrames4<STRIDE, CHANNEL>(frames + k * STRIDE), vld1q_f32(coeffs + k));
+        acc1 = vfmaq_f32(acc1, loadFrames4<STRIDE, CHANNEL>(frames + (k + 4) * STRIDE), vld1q_f32(coeffs + k + 4));
+    }
+    if (k < n) acc0 = vfmaq_f32(acc0, loadFrames4<STRIDE, CHANNEL>(frames + k * STRIDE), vld1q_f32(coeffs + k));
+    return vaddvq_f32(vaddq_f32(acc0, acc1)) * scale;
+#elif defined(SCRATCH_SIMD_X86) && defined(__AVX__)
+    __m256 acc = _mm256_setzero_ps();
+    for (; k + 8 <= n; k += 8) {
+        const __m256 samples = _mm256_set_m128(loadFrames4<STRIDE, CHANNEL>(frames + (k + 4) * STRIDE),
+                                               loadFrames4<STRIDE, CHANNEL>(frames + k * STRIDE));
+#if defined(__FMA__)
+        acc = _mm256_fmadd_ps(samples, _mm256_loadu_ps(coeffs + k), acc);
+#else
+        acc = _mm256_add_ps(acc, _mm256_mul_ps(samples, _mm256_loadu_ps(coeffs + k)));
+#endif
+    }
+    __m128 sum4 = _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+    if (k < n) sum4 = _mm_add_ps(sum4, _mm_mul_ps(loadFrames4<STRIDE, CHANNEL>(frames + k * STRIDE), _mm_loadu_ps(coeffs + k)));
+    sum4 = _mm_add_ps(sum4, _mm_movehl_ps(sum4, sum4));
+    sum4 = _mm_add_ss(sum4, _mm_shuffle_ps(sum4, sum4, 0x55));
+    return _mm_cvtss_f32(sum4) * scale;
+#elif defined(SCRATCH_SIMD_X86)
+    __m128 acc0 = _mm_setzero_ps();
+    __m128 acc1 = _mm_setzero_ps();
+    for (; k + 8 <= n; k += 8) {
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(loadFrames4<STRIDE, CHANNEL>(frames + k * STRIDE), _mm_loadu_ps(coeffs + k)));
+        acc1 = _mm_add_ps(acc1, _mm_mul_ps(loadFrames4<STRIDE, CHANNEL>(frames + (k + 4) * STRIDE), _mm_loadu_ps(coeffs + k + 4)));
+    }
+    if (k < n) acc0 = _mm_add_ps(acc0, _mm_mul_ps(loadFrames4<STRIDE, CHANNEL>(frames + k * STRIDE), _mm_loadu_ps(coeffs + k)));
+    __m128 sum4 = _mm_add_ps(acc0, acc1);
+    sum4 = _mm_add_ps(sum4, _mm_movehl_ps(sum4, sum4));
+    sum4 = _mm_add_ss(sum4, _mm_shuffle_ps(sum4, sum4, 0x55));
+    return _mm_cvtss_f32(sum4) * scale;
+#else
+    float acc = 0.0f;
+    for (; k < n; ++k) {
+        acc += static_cast<float>(frames[k * STRIDE + CHANNEL]) * coeffs[k];
+    }
+    return acc * scale;
+#endif
+}
 
-    inline float getSampleAt(int32_t frameIndex, int channelIndex) const {
-        if (audioData.empty() || totalFrames == 0) return 0.0f;
+// Any channel count, for the Generic layout: gathers the window into planar float first
+template <int TAPS, typename T>
+static inline float convolveStridedTaps(const T* samples, int stride, const float* coeffs, int numTaps = TAPS) {
+    constexpr float scale = std::is_same_v<T, int16_t> ? 1.0f / 32768.0f : 1.0f;
+    const int n = TAPS > 0 ? TAPS : numTaps;
+    alignas(64) float window[TAPS > 0 ? TAPS : MAX_KERNEL_TAPS];
+    for (int k = 0; k < n; ++k) window[k] = static_cast<float>(samples[k * stride]) * scale;
+    return convolveTaps<TAPS>(window, coeffs, n);
+}
 
-        int32_t effectiveFrameIndex = frameIndex;
-        if (loop.load()) {
-            if (totalFrames > 0) {
-                effectiveFrameIndex = frameIndex % totalFrames;
-                if (effectiveFrameIndex < 0) {
-                    effectiveFrameIndex += totalFrames;
-                }
-            } else {
-                effectiveFrameIndex = 0;
-            }
-        } else {
-            effectiveFrameIndex = std::max(0, std::min(frameIndex, totalFrames - 1));
+// Minimal allocator for cache-line (and widest SIMD register) aligned storage.
+template <typename T, size_t Alignment = 64>
+struct AlignedAllocator {
+    using value_type = T;
+    template <typename U> struct rebind { using other = AlignedAllocator<U, Alignment>; };
+    AlignedAllocator() = default;
+    template <typename U> AlignedAllocator(const AlignedAllocator<U, Alignment>&) {}
+    T* allocate(size_t n) { return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(Alignment))); }
+    void deallocate(T* p, size_t) { ::operator delete(p, std::align_val_t(Alignment)); }
+    template <typename U> bool operator==(const AlignedAllocator<U, Alignment>&) const { return true; }
+    template <typename U> bool operator!=(const AlignedAllocator<U, Alignment>&) const { return false; }
+};
+template <typename T> using AlignedVector = std::vector<T, AlignedAllocator<T>>;
+
+// A float sample as stored in a T buffer, and back. int16 holds it scaled by 32768, rounded and
+// clamped, so samples that came from 16-bit PCM round-trip exactly.
+template <typename T>
+static inline T toStoredSample(float sample) {
+    if constexpr (std::is_same_v<T, int16_t>) return static_cast<int16_t>(std::clamp(std::lrintf(sample * 32768.0f), -32768L, 32767L));
+    else return sample;
+}
+static inline float fromStoredSample(float sample) { return sample; }
+static inline float fromStoredSample(int16_t sample) { return static_cast<float>(sample) * (1.0f / 32768.0f); }
+
+// Planar PCM: one contiguous, aligned buffer per channel, each with GUARD_FRAMES frames of padding
+// at both ends. Keeping channels apart lets the kernel use unit-stride vector loads on any channel.
+// Float, or int16 for samples stored at 16 bits (PlanarBuffer16).
+template <typename T>
+struct BasicPlanarBuffer {
+    std::vector<AlignedVector<T>> planes;
+    std::vector<T*> framePtrs; // Frame 0 of each plane. Valid indices: [-GUARD_FRAMES, frames + GUARD_FRAMES)
+    int32_t frames = 0;
+
+    bool empty() const { return planes.empty() || frames == 0; }
+    int32_t channelCount() const { return static_cast<int32_t>(planes.size()); }
+    T* plane(int channel) { return framePtrs[channel]; }
+    const T* plane(int channel) const { return framePtrs[channel]; }
+
+    // Zero-filled storage for numFrames frames (plus guards) per channel
+    void allocate(int32_t numChannels, int32_t numFrames) {
+        planes.assign(numChannels, AlignedVector<T>(static_cast<size_t>(numFrames) + 2 * GUARD_FRAMES, T(0)));
+        framePtrs.resize(numChannels);
+        for (int ch = 0; ch < numChannels; ++ch) framePtrs[ch] = planes[ch].data() + GUARD_FRAMES;
+        frames = numFrames;
+    }
+    void clear() { planes.clear(); framePtrs.clear(); frames = 0; }
+    size_t bytes() const { return planes.empty() ? 0 : planes.size() * planes[0].size() * sizeof(T); }
+
+    // Splits numFrames interleaved float frames into the planes, starting at frame 'firstFrame'
+    void deinterleave(const float* interleaved, int32_t firstFrame, int32_t numFrames) {
+        const int32_t numChannels = channelCount();
+        for (int ch = 0; ch < numChannels; ++ch) {
+            T* dst = framePtrs[ch] + firstFrame;
+            for (int32_t f = 0; f < numFrames; ++f) dst[f] = toStoredSample<T>(interleaved[static_cast<size_t>(f) * numChannels + ch]);
         }
+    }
+};
+using PlanarBuffer = BasicPlanarBuffer<float>;
+using PlanarBuffer16 = BasicPlanarBuffer<int16_t>;
+
+// ---- Kernel design ----
+// Everything in this section is constexpr. The interpolation tables are evaluated by the compiler
+// and emitted as read-only data, so startup does no table work and there is no lazy initialization
+// to race on. The same functions build the few kernels that depend on run-time values (sample-rate
+// conversion, the mipmap half-band filter).
+
+constexpr double constexprAbs(double x) { return x < 0.0 ? -x : x; }
+
+constexpr double constexprSqrt(double x) {
+    if (x <= 0.0) return 0.0;
+    double r = x > 1.0 ? x : 1.0; // Newton from above converges monotonically
+    for (int i = 0; i < 64; ++i) {
+        const double next = 0.5 * (r + x / r);
+        if (next >= r) break;
+        r = next;
+    }
+    return r;
+}
 
-        size_t actualIndex = static_cast<size_t>(effectiveFrameIndex) * channels + (channelIndex % channels);
-        if (actualIndex < audioData.size()) {
-            return audioData[actualIndex];
-        }
-        return 0.0f;
+// sin and cos together: reduce to [-pi, pi], then Taylor series to double precision
+constexpr void constexprSinCos(double x, double& s, double& c) {
+    const double turns = x / (2.0 * M_PI);
+    const double nearest = static_cast<double>(static_cast<long long>(turns + (turns < 0.0 ? -0.5 : 0.5)));
+    const double r = x - nearest * (2.0 * M_PI);
+    double term = r; // r^n / n!, starting at n = 1
+    s = 0.0; c = 1.0;
+    for (int n = 1; n < 40 && constexprAbs(term) > 1e-20; ++n) {
+        if (n % 2 == 1) s += (n % 4 == 1) ? term : -term;
+        else c += (n % 4 == 2) ? -term : term;
+        term *= r / (n + 1);
     }
+}
 
-    // inline float catmullRomInterpolate(float p0, float p1, float p2, float p3, float t) const {
-    //     float t2 = t * t; float t3 = t2 * t;
-    //     return 0.5f * ((2.0f * p1) + (-p0 + p2) * t + (2.0f * p0 - 5.0f * p1 + 4.0f * p2 - p3) * t2 + (-p0 + 3.0f * p1 - 3.0f * p2 + p3) * t3);
-    // }
-};
-// Static member initialization
-std::vector<std::vector<float>> AudioSample::sincTable;
-bool AudioSample::sincTableInitialized = false;
-
-// Bessel function I0 approximation - using a common polynomial approximation
-// Valid for -3.75 <= x <= 3.75. For Kaiser, argument to I0 is beta * sqrt(1 - (term)^2), term is [-1,1]
-// So argument is [0, beta]. If beta is e.g. 6, this range is fine.
-// For x > 3.75, another approximation or asymptotic series would be needed, but for typical beta values, this is often sufficient.
-// Let's use a more general one from Numerical Recipes (approximation for I0(x))
-double AudioSample::bessel_i0_approx(double x) {
-    double ax = std::abs(x);
-    if (ax < 3.75) {
-        double y = x / 3.75;
-        y *= y;
-        return 1.0 + y * (3.5156229 + y * (3.0899424 + y * (1.2067492 + y * (0.2659732 + y * (0.0360768 + y * 0.0045813)))));
-    } else {
-        double y = 3.75 / ax;
-        return (std::exp(ax) / std::sqrt(ax)) * (0.39894228 + y * (0.01328592 + y * (0.00225319 + y * (-0.00157565 + y * (0.00916281 + y * (-0.02057706 + y * (0.02635537 + y * (-0.01647633 + y * 0.00392377))))))));
+// Modified Bessel function of the first kind, order 0: sum over k of ((x/2)^k / k!)^2
+constexpr double besselI0(double x) {
+    double sum = 1.0, term = 1.0;
+    for (int k = 1; k < 64; ++k) {
+        term *= (x / (2.0 * k)) * (x / (2.0 * k));
+        sum += term;
+        if (term < sum * 1e-17) break;
     }
+    return sum;
 }
 
-// n_rel: current sample index relative to the window center: 0 for center, +/- (N/2 -1) for edges
+// n_rel: current sample index relative to the window center: 0 for center, +/- (N/2 - 0.5) for the end taps
 // N_total_taps: total number of taps in the window
-double AudioSample::kaiserWindow(double n_rel_to_center, double N_total_taps, double beta) {
-    if (std::abs(n_rel_to_center) > (N_total_taps / 2.0 - 0.5) && N_total_taps > 1) { // check if n is outside the window span for N>1
-         // Should not happen if sincPoint is correctly calculated relative to window span
+constexpr double kaiserWindow(double n_rel_to_center, double N_total_taps, double beta) {
+    if (constexprAbs(n_rel_to_center) > (N_total_taps / 2.0 - 0.5) && N_total_taps > 1) {
         return 0.0; // Outside the window
     }
-    // Argument for Kaiser window: (2.0 * n_abs_from_zero_indexed_start / (N_total_taps - 1)) - 1.0
-    // where n_abs_from_zero_indexed_start goes from 0 to N_total_taps-1
-    // If n_rel_to_center is - (N/2 - 1) ... 0 ... (N/2 - 1)
-    // then n_zero_indexed = n_rel_to_center + (N/2 -1)
-    // (2.0 * (n_rel_to_center + (N_total_taps/2.0 -1.0) ) / (N_total_taps -1.0) ) - 1.0
-    // This term inside sqrt: ( (2.0*n_idx_from_start) / (N-1) ) - 1.0; where n_idx_from_start is 0 to N-1
-    // Let's use a simpler formulation: term = n_rel_to_center / (N_total_taps/2.0)
-    // This makes 'term' go from -1 to 1 across the main lobe (approx)
-    double term_val_for_bessel_arg;
-    if (N_total_taps <= 1) term_val_for_bessel_arg = 0.0; // Single tap window is always 1.0
-    else term_val_for_bessel_arg = (2.0 * (n_rel_to_center + (N_total_taps/2.0 - 0.5)) / (N_total_taps - 1.0)) - 1.0;
-
-
+    // term goes from -1 at the first tap to 1 at the last
+    double term_val_for_bessel_arg = 0.0; // Single tap window is always 1.0
+    if (N_total_taps > 1) term_val_for_bessel_arg = (2.0 * (n_rel_to_center + (N_total_taps / 2.0 - 0.5)) / (N_total_taps - 1.0)) - 1.0;
     double val_inside_sqrt = 1.0 - term_val_for_bessel_arg * term_val_for_bessel_arg;
     if (val_inside_sqrt < 0) val_inside_sqrt = 0; // Clamp due to precision
+    return besselI0(beta * constexprSqrt(val_inside_sqrt)) / besselI0(beta);
+}
 
-    return bessel_i0_approx(beta * std::sqrt(val_inside_sqrt)) / bessel_i0_approx(beta);
+// Kaiser window for a kernel whose integer-frame tap is centreTap. The window's centre sits between
+// centreTap and centreTap + 1 ((numTaps-1)/2.0 for the linear-phase kernel). Each half is evaluated
+// as part of a symmetric window of its own length, so both reach zero at the ends; moving
+// centreTap off the middle gives the asymmetric low-delay window.
+constexpr void fillKaiserWindow(double* window, int numTaps, double beta, int centreTap) {
+    for (int i = 0; i < numTaps; ++i) {
+        const double kaiser_n_rel = static_cast<double>(i) - (centreTap + 0.5);
+        const double halfWindowTaps = kaiser_n_rel < 0.0 ? 2.0 * (centreTap + 1) : 2.0 * (numTaps - 1 - centreTap);
+        window[i] = kaiserWindow(kaiser_n_rel, halfWindowTaps, beta);
+    }
 }
 
+// Writes one phase of a windowed sinc kernel, normalized to unity DC gain.
+// cutoff is relative to the source Nyquist: 1.0 for plain interpolation, 1/scale for the anti-aliasing banks.
+// When fractionalOffset is 0 the interpolated point is the sample at tap centreTap; getAudio lines
+// that tap up with the integer frame index.
+constexpr void fillWindowedSincRow(float* coefficients, const double* window, int numTaps, double fractionalOffset,
+                                   double cutoff, int centreTap) {
+    // sin(pi * sincPoint) for consecutive taps by rotation: one sin/cos per row instead of per tap
+    const double step = M_PI * cutoff;
+    double stepSin = 0.0, stepCos = 0.0, sinValue = 0.0, cosValue = 0.0;
+    constexprSinCos(step, stepSin, stepCos);
+    constexprSinCos((-centreTap - fractionalOffset) * step, sinValue, cosValue);
+
+    float sumCoeffs = 0.0f; // For normalization
+    for (int i = 0; i < numTaps; ++i) {
+        // sincPoint: distance from tap 'i' to the point we interpolate to.
+        // If `i` is `centreTap`, then `sincPoint = -fractionalOffset`.
+        // If `i` is `centreTap + 1`, then `sincPoint = 1 - fractionalOffset`.
+        const double sincPoint = ((static_cast<double>(i) - centreTap) - fractionalOffset) * cutoff;
+        const double sincValue = constexprAbs(sincPoint) < 1e-9 ? 1.0 : sinValue / (M_PI * sincPoint);
+        coefficients[i] = static_cast<float>(sincValue * window[i]);
+        sumCoeffs += coefficients[i];
+
+        const double nextSin = sinValue * stepCos + cosValue * stepSin;
+        cosValue = cosValue * stepCos - sinValue * stepSin;
+        sinValue = nextSin;
+    }
 
-void AudioSample::precalculateSincTable() {
-    if (sincTableInitialized) return;
+    // Normalize coefficients to sum to 1.0 to ensure gain is preserved
+    if (constexprAbs(sumCoeffs) > 1e-6) { // Avoid division by zero if all coeffs are zero
+        for (int i = 0; i < numTaps; ++i) {
+            coefficients[i] /= sumCoeffs;
+        }
+    }
+}
 
-    sincTable.resize(SUBDIVISION_STEPS, std::vector<float>(NUM_TAPS));
-    double I0_beta = bessel_i0_approx(KAISER_BETA); // Denominator for Kaiser window
+// One-off kernel phase with its own window (centreTap < 0: linear phase, numTaps/2 - 1)
+inline void fillWindowedSinc(float* coefficients, int numTaps, double fractionalOffset, double cutoff, double beta = KAISER_BETA,
+                             int centreTap = -1) {
+    if (centreTap < 0) centreTap = numTaps / 2 - 1;
+    double window[MAX_KERNEL_TAPS] = {};
+    fillKaiserWindow(window, numTaps, beta, centreTap);
+    fillWindowedSincRow(coefficients, window, numTaps, fractionalOffset, cutoff, centreTap);
+}
 
-    for (int j = 0; j < SUBDIVISION_STEPS; ++j) {
-        double fractionalOffset = static_cast<double>(j) / SUBDIVISION_STEPS;
+// View of a polyphase windowed-sinc coefficient block: 64-byte-aligned rows of 'taps' floats. A
+// linear-phase kernel satisfies c(f, i) == c(1 - f, taps - 1 - i), so only phases f in [0, 0.5]
+// are stored (phaseCount/2 + 1 rows); low-delay kernels store every phase. getAudio interpolates
+// linearly between adjacent phases.
+struct SincKernelTable {
+    const float* rows = nullptr;
+    float rateScale = 1.0f; // Cutoff is 1/rateScale of the source Nyquist
+    int taps = 0;
+    int centreTap = 0;   // Tap aligned with the playhead's integer frame
+    bool symmetric = true;
+    int phaseCount = 0;  // Power of two, so the phase is the top bits of the playhead fraction
+    int phaseShift = 0;  // 32 - log2(phaseCount)
+
+    // Writes the kernel for a 0.32 fixed-point fractional offset into 'out' ('taps' floats).
+    inline void interpolate(uint32_t fraction, float* out) const {
+        const int j = static_cast<int>(fraction >> phaseShift);
+        const float t = static_cast<float>(fraction & ((uint32_t(1) << phaseShift) - 1u)) * (1.0f / static_cast<float>(uint64_t(1) << phaseShift));
+        const int half = phaseCount / 2;
+        if (j < half || !symmetric) {
+            const float* a = rows + static_cast<size_t>(j) * taps;
+            const float* b = a + taps;
+            for (int i = 0; i < taps; ++i) out[i] = a[i] + t * (b[i] - a[i]);
+        } else {
+            // Phases past 0.5 are the stored rows P - j and P - j - 1, read back to front
+            const float* a = rows + static_cast<size_t>(phaseCount - j) * taps + (taps - 1);
+            const float* b = a - taps;
+            for (int i = 0; i < taps; ++i) out[i] = a[-i] + t * (b[-i] - a[-i]);
+        }
+    }
+};
 
-        float sumCoeffs = 0.0f; // For normalization
+constexpr int phaseShiftFor(int numPhases) {
+    int shift = 32;
+    while ((1 << (32 - shift)) < numPhases) --shift;
+    return shift;
+}
 
-        for (int i = 0; i < NUM_TAPS; ++i) {
-            // sincPoint: distance from the tap 'i' to the desired interpolation point (fractionalOffset)
-            // The center of the NUM_TAPS samples is between tap NUM_TAPS/2 - 1 and NUM_TAPS/2.
-            // We want the filter kernel to be centered such that when fractionalOffset is 0,
-            // the interpolated point corresponds to the sample at index (NUM_TAPS/2 - 1) in the input kernel.
-            // Or, if we consider the "ideal" sample to be at `fractionalOffset` relative to `input_kernel[NUM_TAPS/2 -1]`.
-            // Let the current tap be `i`. Its position relative to the *start of the window* is `i`.
-            // The point we are interpolating *to* is `(NUM_TAPS/2 - 1) + fractionalOffset`.
-            // So, distance from tap `i` to this point is `i - ((NUM_TAPS/2 - 1) + fractionalOffset)`.
-            // Or, `( (double)i - (NUM_TAPS/2.0 - 1.0) ) - fractionalOffset` seems common.
-            // This makes `sincPoint` centered around `fractionalOffset`.
-            // If `i` is `NUM_TAPS/2 -1`, then `sincPoint = -fractionalOffset`.
-            // If `i` is `NUM_TAPS/2`, then `sincPoint = 1 - fractionalOffset`.
-            double sincPoint = (static_cast<double>(i) - (NUM_TAPS / 2.0 - 1.0)) - fractionalOffset;
+// Builds a kernel into caller-owned storage, for kernels whose parameters are only known at run time
+inline SincKernelTable buildSincKernel(AlignedVector<float>& storage, int numTaps, int numPhases, float scale, double beta,
+                                       int peakTap = -1) {
+    const int centreTap = peakTap < 0 ? numTaps / 2 - 1 : peakTap;
+    const bool symmetric = (centreTap == numTaps / 2 - 1);
+    const int storedRows = symmetric ? numPhases / 2 + 1 : numPhases + 1;
+    storage.assign(static_cast<size_t>(storedRows) * numTaps, 0.0f);
+    double window[MAX_KERNEL_TAPS] = {};
+    fillKaiserWindow(window, numTaps, beta, centreTap);
+    for (int j = 0; j < storedRows; ++j) {
+        fillWindowedSincRow(storage.data() + static_cast<size_t>(j) * numTaps, window, numTaps,
+                            static_cast<double>(j) / numPhases, 1.0 / scale, centreTap);
+    }
+    return SincKernelTable{storage.data(), scale, numTaps, centreTap, symmetric, numPhases, phaseShiftFor(numPhases)};
+}
 
-            double sincValue;
-            if (std::abs(sincPoint) < 1e-9) { // Check for sincPoint == 0
-                sincValue = 1.0;
-            } else {
-                sincValue = std::sin(M_PI * sincPoint) / (M_PI * sincPoint);
-            }
+// Compile-time coefficient block for one kernel
+template <int TAPS, int PHASES, int CENTRE>
+struct KernelCoefficients {
+    static constexpr bool SYMMETRIC = (CENTRE == TAPS / 2 - 1);
+    static constexpr int ROWS = SYMMETRIC ? PHASES / 2 + 1 : PHASES + 1;
+    alignas(64) float rows[ROWS * TAPS] = {};
+};
+
+template <int TAPS, int PHASES, int CENTRE = TAPS / 2 - 1>
+constexpr KernelCoefficients<TAPS, PHASES, CENTRE> makeKernelCoefficients(double scale, double beta) {
+    KernelCoefficients<TAPS, PHASES, CENTRE> k;
+    double window[TAPS] = {};
+    fillKaiserWindow(window, TAPS, beta, CENTRE);
+    for (int j = 0; j < k.ROWS; ++j) {
+        fillWindowedSincRow(k.rows + j * TAPS, window, TAPS, static_cast<double>(j) / PHASES, 1.0 / scale, CENTRE);
+    }
+    return k;
+}
+
+template <int TAPS, int PHASES, int CENTRE>
+constexpr SincKernelTable kernelTableFor(const KernelCoefficients<TAPS, PHASES, CENTRE>& k, float scale) {
+    return SincKernelTable{k.rows, scale, TAPS, CENTRE, k.SYMMETRIC, PHASES, phaseShiftFor(PHASES)};
+}
+
+constexpr int lowDelayCentreTap(int taps) { return taps - 1 - taps / LOW_DELAY_LOOKAHEAD_DIVISOR; }
+
+// Anti-aliasing banks widen in proportion to their scale, rounded up to the SIMD kernel's multiple of 8
+constexpr int antiAliasBankTaps(int bank) {
+    const float width = NUM_TAPS * ANTI_ALIAS_BANK_SCALES[bank];
+    int taps = static_cast<int>(width);
+    if (static_cast<float>(taps) < width) ++taps;
+    taps = ((taps + 7) / 8) * 8;
+    return taps < MAX_KERNEL_TAPS ? taps : MAX_KERNEL_TAPS;
+}
+
+// Linear-phase and low-delay tables, one per InterpolationQuality tier
+constexpr auto SINC_COEFFICIENTS_4 = makeKernelCoefficients<4, SUBDIVISION_STEPS>(1.0, QUALITY_TIER_BETA[0]);
+constexpr auto SINC_COEFFICIENTS_8 = makeKernelCoefficients<8, SUBDIVISION_STEPS>(1.0, QUALITY_TIER_BETA[1]);
+constexpr auto SINC_COEFFICIENTS_16 = makeKernelCoefficients<16, SUBDIVISION_STEPS>(1.0, QUALITY_TIER_BETA[2]);
+constexpr auto SINC_COEFFICIENTS_32 = makeKernelCoefficients<32, SUBDIVISION_STEPS>(1.0, QUALITY_TIER_BETA[3]);
+constexpr auto SINC_COEFFICIENTS_64 = makeKernelCoefficients<64, SUBDIVISION_STEPS>(1.0, QUALITY_TIER_BETA[4]);
+constexpr auto LOW_DELAY_COEFFICIENTS_4 = makeKernelCoefficients<4, SUBDIVISION_STEPS, lowDelayCentreTap(4)>(1.0, QUALITY_TIER_BETA[0]);
+constexpr auto LOW_DELAY_COEFFICIENTS_8 = makeKernelCoefficients<8, SUBDIVISION_STEPS, lowDelayCentreTap(8)>(1.0, QUALITY_TIER_BETA[1]);
+constexpr auto LOW_DELAY_COEFFICIENTS_16 = makeKernelCoefficients<16, SUBDIVISION_STEPS, lowDelayCentreTap(16)>(1.0, QUALITY_TIER_BETA[2]);
+constexpr auto LOW_DELAY_COEFFICIENTS_32 = makeKernelCoefficients<32, SUBDIVISION_STEPS, lowDelayCentreTap(32)>(1.0, QUALITY_TIER_BETA[3]);
+constexpr auto LOW_DELAY_COEFFICIENTS_64 = makeKernelCoefficients<64, SUBDIVISION_STEPS, lowDelayCentreTap(64)>(1.0, QUALITY_TIER_BETA[4]);
+constexpr SincKernelTable SINC_TABLES[NUM_QUALITY_TIERS] = {
+        kernelTableFor(SINC_COEFFICIENTS_4, 1.0f), kernelTableFor(SINC_COEFFICIENTS_8, 1.0f), kernelTableFor(SINC_COEFFICIENTS_16, 1.0f),
+        kernelTableFor(SINC_COEFFICIENTS_32, 1.0f), kernelTableFor(SINC_COEFFICIENTS_64, 1.0f)};
+constexpr SincKernelTable LOW_DELAY_TABLES[NUM_QUALITY_TIERS] = {
+        kernelTableFor(LOW_DELAY_COEFFICIENTS_4, 1.0f), kernelTableFor(LOW_DELAY_COEFFICIENTS_8, 1.0f), kernelTableFor(LOW_DELAY_COEFFICIENTS_16, 1.0f),
+        kernelTableFor(LOW_DELAY_COEFFICIENTS_32, 1.0f), kernelTableFor(LOW_DELAY_COEFFICIENTS_64, 1.0f)};
+
+// Anti-aliasing banks used when |rate| > 1 (see ANTI_ALIAS_BANK_SCALES)
+constexpr auto ANTI_ALIAS_COEFFICIENTS_0 = makeKernelCoefficients<antiAliasBankTaps(0), ANTI_ALIAS_PHASES>(ANTI_ALIAS_BANK_SCALES[0], KAISER_BETA);
+constexpr auto ANTI_ALIAS_COEFFICIENTS_1 = makeKernelCoefficients<antiAliasBankTaps(1), ANTI_ALIAS_PHASES>(ANTI_ALIAS_BANK_SCALES[1], KAISER_BETA);
+constexpr auto ANTI_ALIAS_COEFFICIENTS_2 = makeKernelCoefficients<antiAliasBankTaps(2), ANTI_ALIAS_PHASES>(ANTI_ALIAS_BANK_SCALES[2], KAISER_BETA);
+constexpr auto ANTI_ALIAS_COEFFICIENTS_3 = makeKernelCoefficients<antiAliasBankTaps(3), ANTI_ALIAS_PHASES>(ANTI_ALIAS_BANK_SCALES[3], KAISER_BETA);
+constexpr auto ANTI_ALIAS_COEFFICIENTS_4 = makeKernelCoefficients<antiAliasBankTaps(4), ANTI_ALIAS_PHASES>(ANTI_ALIAS_BANK_SCALES[4], KAISER_BETA);
+constexpr auto ANTI_ALIAS_COEFFICIENTS_5 = makeKernelCoefficients<antiAliasBankTaps(5), ANTI_ALIAS_PHASES>(ANTI_ALIAS_BANK_SCALES[5], KAISER_BETA);
+constexpr SincKernelTable ANTI_ALIAS_BANKS[NUM_ANTI_ALIAS_BANKS] = {
+        kernelTableFor(ANTI_ALIAS_COEFFICIENTS_0, ANTI_ALIAS_BANK_SCALES[0]), kernelTableFor(ANTI_ALIAS_COEFFICIENTS_1, ANTI_ALIAS_BANK_SCALES[1]),
+        kernelTableFor(ANTI_ALIAS_COEFFICIENTS_2, ANTI_ALIAS_BANK_SCALES[2]), kernelTableFor(ANTI_ALIAS_COEFFICIENTS_3, ANTI_ALIAS_BANK_SCALES[3]),
+        kernelTableFor(ANTI_ALIAS_COEFFICIENTS_4, ANTI_ALIAS_BANK_SCALES[4]), kernelTableFor(ANTI_ALIAS_COEFFICIENTS_5, ANTI_ALIAS_BANK_SCALES[5])};
+
+static_assert([] {
+    for (int tier = 0; tier < NUM_QUALITY_TIERS; ++tier) {
+        if (SINC_TABLES[tier].taps != QUALITY_TIER_TAPS[tier] || LOW_DELAY_TABLES[tier].taps != QUALITY_TIER_TAPS[tier]) return false;
+    }
+    return true;
+}(), "SINC_TABLES / LOW_DELAY_TABLES must follow QUALITY_TIER_TAPS");
+
+constexpr size_t KERNEL_TABLE_BYTES =
+        sizeof(SINC_COEFFICIENTS_4) + sizeof(SINC_COEFFICIENTS_8) + sizeof(SINC_COEFFICIENTS_16) + sizeof(SINC_COEFFICIENTS_32) + sizeof(SINC_COEFFICIENTS_64) +
+        sizeof(LOW_DELAY_COEFFICIENTS_4) + sizeof(LOW_DELAY_COEFFICIENTS_8) + sizeof(LOW_DELAY_COEFFICIENTS_16) + sizeof(LOW_DELAY_COEFFICIENTS_32) +
+        sizeof(LOW_DELAY_COEFFICIENTS_64) + sizeof(ANTI_ALIAS_COEFFICIENTS_0) + sizeof(ANTI_ALIAS_COEFFICIENTS_1) + sizeof(ANTI_ALIAS_COEFFICIENTS_2) +
+        sizeof(ANTI_ALIAS_COEFFICIENTS_3) + sizeof(ANTI_ALIAS_COEFFICIENTS_4) + sizeof(ANTI_ALIAS_COEFFICIENTS_5);
 
-            // For Kaiser window, 'n_rel' is distance from center of the window.
-            // Window is indexed 0 to NUM_TAPS-1. Center is at (NUM_TAPS-1)/2.0.
-            // So, n_rel = i - (NUM_TAPS-1)/2.0
-            double kaiser_n_rel = static_cast<double>(i) - (NUM_TAPS - 1.0) / 2.0;
-            double windowValue = kaiserWindow(kaiser_n_rel, NUM_TAPS, KAISER_BETA);
-            // The original kaiserWindow helper used n_rel_to_center directly, this is fine.
-            // double windowValue = kaiserWindow( (double)i - (NUM_TAPS/2.0 -1.0) , NUM_TAPS, KAISER_BETA); // This was less clear
+class AudioEngine;
+
+// Read-only, zero-copy view of an asset's bytes. Entries stored uncompressed in the APK (see
+// noCompress in build.gradle.kts) are mapped straight out of it through AAsset_openFileDescriptor,
+// so pages are faulted in as the decoder reaches them and, unless locked (lockResident), can be
+// dropped again under memory pressure. A compressed entry can only be had through
+// AAsset_getBuffer, which inflates it into a heap copy.
+class AssetMapping {
+public:
+    AssetMapping() = default;
+    ~AssetMapping() { close(); }
+    AssetMapping(const AssetMapping&) = delete;
+    AssetMapping& operator=(const AssetMapping&) = delete;
+    // allowInflate: accept an inflated copy when the entry cannot be mapped
+    bool open(AAssetManager* assetManager, const std::string& path, bool allowInflate = true);
+    void close();
+    const uint8_t* data() const { return data_; }
+    size_t size() const { return size_; }
+    // Faults in bytes [offset, offset + length) and locks them in RAM until close(), for data read
+    // from the audio callback, which must not take a page fault. Read randomly from then on. False
+    // if the pages cannot be locked, leaving nothing locked and nothing read ahead when the range
+    // would not fit under RLIMIT_MEMLOCK alongside what other mappings hold.
+    bool lockResident(size_t offset, size_t length);
+    size_t lockedBytes() const { return lockedLength_; }
+
+private:
+    AAsset* asset_ = nullptr; // Owns the inflated copy, when there is one
+    void* mapBase_ = nullptr;
+    size_t mapLength_ = 0;
+    void* lockedBase_ = nullptr;
+    size_t lockedLength_ = 0;
+    static std::atomic<size_t> lockedTotal_; // Locked by all mappings, against RLIMIT_MEMLOCK
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+    bool mapFile(int fd, int64_t offset, size_t length); // Closes fd
+};
+
+// A music track decoded a little at a time on its own thread, so only a few hundred milliseconds
+// of it are ever resident. The producer keeps STREAM_DECODE_AHEAD_FRAMES queued in a wait-free
+// SPSC ring of interleaved frames, and the music voice drains it into a planar window that the
+// usual kernels read from (see Voice::refillStreamWindow). A stream opened at a frame other than 0
+// positions the decoder with its seek API before anything is queued, so seeking is a new stream
+// installed at a block boundary like any other sample. Streams play forwards only and never loop.
+// A stored asset is decoded out of its mapping; a compressed one is read through AAsset_read
+// rather than inflated whole.
+class StreamingSource {
+public:
+    ~StreamingSource() { close(); }
+    // Opens an MP3 or WAV asset at 'startFrame' and queues the first chunk before returning
+    bool open(AAssetManager* assetManager, const std::string& path, int64_t startFrame);
+    int32_t channels = 0;
+    uint32_t sampleRate = 0;
+    int64_t startFrame = 0;
+
+    // Consumer side, on the audio thread. read() moves up to maxFrames queued frames into planes
+    // [0, channels) of 'window', from frame 'firstFrame' on, and returns how many it moved.
+    int32_t read(PlanarBuffer& window, int32_t firstFrame, int32_t maxFrames);
+    // The decoder has reached the end and every frame it produced has been read
+    bool drained() const;
+    void noteUnderrun() { underruns_.store(underruns_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed); }
+
+private:
+    std::string path_;
+    AssetMapping mapping_;
+    AAsset* asset_ = nullptr; // Only when the asset could not be mapped
+    bool isMp3_ = false;
+    bool decoderOpen_ = false;
+    drmp3 mp3_;
+    drwav wav_;
+    AlignedVector<float> ring_;
+    std::vector<float> decodeChunk_;
+    alignas(64) std::atomic<uint64_t> readFrame_{0};  // Consumer
+    alignas(64) std::atomic<uint64_t> writeFrame_{0}; // Producer
+    std::atomic<bool> endOfStream_{false};
+    std::atomic<uint32_t> underruns_{0};
+    std::atomic<bool> stopping_{false};
+    std::thread producer_;
+    bool fill(); // Decodes one chunk if the ring wants one; false when there was nothing to do
+    void produce();
+    void close();
+    static size_t onRead(void* userData, void* bufferOut, size_t bytesToRead);
+    static bool seekAsset(void* userData, int offset, int whence);
+    static drmp3_bool32 onSeekMp3(void* userData, int offset, drmp3_seek_origin origin);
+    static drmp3_bool32 onTellMp3(void* userData, drmp3_int64* cursor);
+    static drwav_bool32 onSeekWav(void* userData, int offset, drwav_seek_origin origin);
+};
 
-            sincTable[j][i] = static_cast<float>(sincValue * windowValue);
-            sumCoeffs += sincTable[j][i];
+// An MP3 or WAV asset decoded out of its AssetMapping a chunk at a time, to interleaved float.
+// The length is known once open() returns, so the destination can be allocated up front.
+class AssetDecoder {
+public:
+    ~AssetDecoder() { close(); }
+    bool open(AAssetManager* assetManager, const std::string& path);
+    int32_t channels = 0;
+    uint32_t sampleRate = 0;
+    int32_t totalFrames = 0;
+    // Decodes up to maxFrames frames; returns fewer only at the end of the data
+    int32_t read(float* interleaved, int32_t maxFrames);
+    void close();
+
+    // MP3 only. Up to count - 1 MP3 frame boundaries that split [begin, end) into ranges of at
+    // least minFrames, in order; empty when the file cannot be split.
+    std::vector<int32_t> splitPoints(int32_t begin, int32_t end, int count, int32_t minFrames);
+    // MP3 only. Decodes frames [begin, end) into the same frames of 'dest' on a decoder of its own,
+    // so it can run on several threads at once and alongside read(). Call splitPoints() first.
+    // Returns the number of frames written.
+    template <typename T>
+    int32_t decodeRange(int32_t begin, int32_t end, BasicPlanarBuffer<T>& dest, const std::atomic<bool>& cancel) const;
+
+private:
+    AssetMapping mapping_;
+    bool isMp3_ = false;
+    bool decoderOpen_ = false;
+    drmp3 mp3_;
+    drwav wav_;
+    std::vector<drmp3_seek_point> seekPoints_;
+    int32_t mp3FrameSamples_ = 0;
+    int64_t seekPointFrame(const drmp3_seek_point& point) const;
+};
+
+// Windowed-sinc sample rate conversion between two fixed rates. Source positions are computed
+// exactly from the output frame index (no accumulated increment), so any range of output frames
+// converts on its own: split across threads, or as soon as the source frames under it are decoded.
+class RateConverter {
+public:
+    RateConverter(uint32_t sourceRate, uint32_t destRate);
+    int taps() const { return taps_; }
+    int32_t outputFrames(int32_t sourceFrames) const {
+        return static_cast<int32_t>((static_cast<uint64_t>(sourceFrames) * destRate_ + sourceRate_ - 1) / sourceRate_);
+    }
+    // Output frames [0, n) whose kernels only read the first sourceFrames source frames
+    int32_t outputFramesCovered(int32_t sourceFrames) const;
+    // Writes output frames [begin, end) of 'dest' (float or int16), spread over up to maxThreads
+    // threads (the caller's included). Reads past the decoded source rely on its guard frames
+    // being silent. Stops early, leaving the range incomplete, once 'cancel' is set.
+    template <typename T>
+    void convert(const PlanarBuffer& source, BasicPlanarBuffer<T>& dest, int32_t begin, int32_t end,
+                 unsigned maxThreads = MAX_SAMPLE_RATE_CONVERSION_THREADS, const std::atomic<bool>* cancel = nullptr) const;
+
+private:
+    uint64_t sourceRate_;
+    uint64_t destRate_;
+    int taps_;
+    AlignedVector<float> kernelStorage_;
+    SincKernelTable kernel_;
+    template <typename T>
+    void convertRange(const PlanarBuffer& source, BasicPlanarBuffer<T>& dest, int32_t begin, int32_t end,
+                      const std::atomic<bool>* cancel) const;
+};
+
+// Decoded PCM, shared read-only by every voice that plays it. Once load() returns nothing changes
+// except what loadFinisher_ fills in behind the decodedFrames watermark (the rest of the decode,
+// then the loop seam) and the mipmap levels it appends afterwards, published through
+// mipmapLevelsReady. A WAV played in place has no audioData; see DirectSource.
+struct AudioSample {
+    std::string filePath;
+    // Planar PCM with GUARD_FRAMES frames of silent padding at both ends of every channel.
+    PlanarBuffer audioData;
+    // Set instead of audioData for a sample stored as 16-bit (load()'s storeAsInt16), same layout
+    PlanarBuffer16 audioData16;
+    bool storedAsInt16() const { return !audioData16.empty(); }
+    // LOOP_SEAM_FRAMES frames starting 2 * GUARD_FRAMES before the end, wrapping to the start
+    // (see buildLoopSeam). Looping voices read across the loop point from here.
+    PlanarBuffer loopSeam;
+    int32_t totalFrames = 0;
+    int32_t channels = 0;
+    uint32_t sampleRate = 0;
+
+    // Decimated copies of audioData, same planar + guard-padded layout. Level L (0-based) is
+    // 2^(L+1) times shorter. Built on loadFinisher_ once decoding is done; levels
+    // [0, mipmapLevelsReady) are readable.
+    struct MipLevel {
+        PlanarBuffer data;
+        PlanarBuffer loopSeam;
+    };
+    MipLevel mipLevels[MIPMAP_LEVELS];
+    std::atomic<int> mipmapLevelsReady{0};
+    void buildMipmaps();
+
+    // Frames [0, decodedFrames) of audioData are final (release/acquire). It only reaches
+    // totalFrames once the loop seam is built as well, so a voice wraps only after that.
+    std::atomic<int32_t> decodedFrames{0};
+    std::atomic<bool> finisherCancel_{false};
+    std::thread loadFinisher_;
+    void stopLoadFinisher();
+
+    ~AudioSample() { stopLoadFinisher(); }
+
+    // Set instead of audioData for a streamed music track; totalFrames stays 0 as the length is
+    // not known up front
+    std::unique_ptr<StreamingSource> stream;
+
+    // Set instead of audioData for a WAV played in place (PLAY_WAV_IN_PLACE): 'frames' is its data
+    // chunk, interleaved, inside 'mapping'. Kernels within GUARD_FRAMES of either end read past the
+    // data, so the first and last 2 * GUARD_FRAMES frames are also copied out as planar float with
+    // silent guards ('head' holds frames from 0, 'tail' from totalFrames - 2 * GUARD_FRAMES). The
+    // data chunk is locked in RAM (AssetMapping::lockResident) and counted by residentBytes.
+    struct DirectSource {
+        AssetMapping mapping;
+        const void* frames = nullptr;
+        SampleFormat format = SampleFormat::InterleavedInt16;
+        int32_t channels = 0;
+        PlanarBuffer head;
+        PlanarBuffer tail;
+        // Frames [first, first + count) of one channel as float
+        void readChannel(int channel, int32_t first, int32_t count, float* out) const;
+    };
+    std::unique_ptr<DirectSource> direct;
+    // Maps 'path' as a DirectSource if it qualifies; false leaves it to be decoded
+    bool openDirect(AAssetManager* assetManager, const std::string& path, bool convertToOutputRate);
+    bool playable() const { return totalFrames > 0 || stream; }
+    void openStream(AAssetManager* assetManager, const std::string& path, int64_t startFrame);
+
+    static bool hasExtension(const std::string& path, const std::string& extension);
+    // The asset load() would pick for basePath (as given if it has an extension, else .mp3, then
+    // .wav), found without decoding anything. Empty if there is none.
+    static std::string resolveAssetPath(AAssetManager* assetManager, const std::string& basePath);
+    // PCM held by this sample: the decoded data, its seams and the mipmap levels built so far
+    size_t residentBytes() const;
+    void load(AAssetManager* assetManager, const std::string& basePath, bool buildMipmapPyramid = false, bool convertToOutputRate = false,
+              bool storeAsInt16 = false);
+    uint32_t outputSampleRate = 0; // Stream rate; 0 plays the source at its own rate
+    double sourceRateRatio_ = 1.0; // sampleRate / outputSampleRate, folded into the playback increment
+
+    // Copies the frames around the loop point of 'data' into 'seam' as float, wrapping at both
+    // ends. The modulo handles samples shorter than the seam itself.
+    template <typename T>
+    static void buildLoopSeam(const BasicPlanarBuffer<T>& data, PlanarBuffer& seam);
+
+    // Decoder state carried from load() to loadFinisher_, released once the sample is complete
+    struct PendingDecode {
+        AssetDecoder decoder;
+        std::unique_ptr<RateConverter> converter; // Set when converting to outputSampleRate
+        PlanarBuffer source;                      // At the file's own rate, when converting
+        std::vector<float> chunk;
+        uint32_t sourceRate = 0;
+        int32_t sourceDecoded = 0;                // Source frames [0, sourceDecoded) are in
+        int32_t sequentialEnd = 0;                // Where decodeNextChunk() stops; the rest goes to segment workers
+        int32_t converted = 0;
+        std::chrono::steady_clock::time_point started;
+    };
+    std::unique_ptr<PendingDecode> pending_;
+    // A range of the source decoded on a worker thread of its own (see startParallelDecode)
+    struct DecodeSegment {
+        int32_t begin = 0;
+        int32_t end = 0;
+        int32_t decoded = 0;
+        std::thread worker;
+    };
+    // Opens 'path' and sizes audioData (or audioData16) for it without decoding anything
+    bool beginDecode(AAssetManager* assetManager, const std::string& path, bool convertToOutputRate, bool storeAsInt16);
+    // Calls f with the buffer the decoder writes to: the source when converting, else the sample's own
+    template <typename F>
+    decltype(auto) withDecodeTarget(F&& f) {
+        if (pending_->converter) return f(pending_->source);
+        if (storedAsInt16()) return f(audioData16);
+        return f(audioData);
+    }
+    // Decodes the next chunk and moves decodedFrames up; false once sequentialEnd is reached
+    bool decodeNextChunk();
+    // Converts what the decoded source now covers and moves decodedFrames up to it. A chunk is
+    // converted on the calling thread; a joined segment may spread over conversionThreads.
+    void publishDecoded(unsigned conversionThreads = 1);
+    void startParallelDecode(std::vector<DecodeSegment>& segments);
+    void completeDecode();
+    void decodeRemainder(bool buildMipmapPyramid);
+};
+
+// Decoded samples by the asset path they resolved to (and how they were prepared, see key()),
+// evicted least recently used first once their PCM exceeds the byte budget. Entries are shared:
+// a voice still playing an evicted sample keeps it alive, the cache only forgets it. Thread-safe;
+// used from the engine's background threads, never from the callback.
+class SampleCache {
+public:
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+        size_t bytes = 0;
+        size_t entries = 0;
+        size_t byteBudget = 0;
+    };
+
+    explicit SampleCache(size_t byteBudget) { stats_.byteBudget = byteBudget; }
+
+    static std::string key(const std::string& resolvedPath, bool mipmaps, bool convertedRate, bool int16) {
+        return resolvedPath + (mipmaps ? "|mip" : "") + (convertedRate ? "|src" : "") + (int16 ? "|s16" : "");
+    }
+    // Counts a hit or a miss. A hit becomes the most recently used entry.
+    std::shared_ptr<AudioSample> find(const std::string& key);
+    // Adds a freshly decoded sample (or refreshes it) and evicts down to the budget. The entry just
+    // added is never evicted, even when it alone exceeds the budget.
+    void insert(const std::string& key, std::shared_ptr<AudioSample> sample);
+    void setByteBudget(size_t byteBudget);
+    Stats stats() const;
+    void clear();
+    // Neither counts as a lookup nor changes the LRU order
+    bool contains(const std::string& key) const;
+    size_t freeBytes() const;
+    // For prefetched samples: adds the entry only if it fits in the free budget, evicting nothing
+    bool insertIfRoom(const std::string& key, std::shared_ptr<AudioSample> sample);
+
+private:
+    struct Entry {
+        std::string key;
+        std::shared_ptr<AudioSample> sample;
+        size_t bytes;
+    };
+    std::list<Entry> entries_; // Most recently used first
+    std::unordered_map<std::string, std::list<Entry>::iterator> index_;
+    Stats stats_;
+    mutable std::mutex mutex_;
+    // Moves the victims into evicted, which the caller declares ahead of its lock so the samples
+    // (and their mappings and threads) are torn down after mutex_ is released
+    void evictOverBudget(const Entry* keep, std::list<Entry>& evicted);
+};
+
+// Lowest first. A new voice may steal only a voice of the same or lower priority.
+enum class VoicePriority { OneShot, Music, Platter };
+
+// The engine roles that load assets in the background, and how the latest load for each went.
+// The values are shared with Kotlin (MainActivity.getLoadState).
+enum class LoadTarget : int { Platter = 0, Music = 1 };
+constexpr int NUM_LOAD_TARGETS = 2;
+enum class LoadState : int { Idle = 0, Loading = 1, Ready = 2, Failed = 3 };
+
+// A control change from a JNI thread, applied by the callback before it renders a block. Plain
+// data, so the queue holds commands by value in preallocated slots.
+struct EngineCommand {
+    enum class Type : uint8_t {
+        StartVoice,            // voice, generation, sample, value (gain), rate, loop, playOnceThenLoop, playing, useEngineRate
+        SetVoicePlaying,       // voice, playing
+        SeekVoice,             // voice, playhead
+        PlatterControl,        // fingerDown, useEngineRate, playing, rate: one complete scratch update
+        SetPlatterFaderVolume, // value
+        SetMusicMasterVolume,  // value
+        SetPowerSaveMode,      // enabled
+    };
+    Type type = Type::SetPowerSaveMode;
+    bool loop = false;
+    bool playOnceThenLoop = false;
+    bool playing = false;
+    bool useEngineRate = false;
+    bool fingerDown = false;
+    bool enabled = false;
+    int16_t voice = -1;
+    uint32_t generation = 0;
+    float value = 0.0f;
+    float rate = 1.0f;
+    int64_t playhead = 0;
+    const AudioSample* sample = nullptr;
+};
+
+// Wait-free single-producer/single-consumer ring. The consumer's and producer's indices sit on
+// separate cache lines so the two threads do not false-share, and the producer caches the last
+// consumer index it saw so a push usually touches only its own line. A batch is published with a
+// single store, so the consumer sees all of it or none of it.
+template <typename T, size_t CAPACITY>
+class SpscQueue {
+    static_assert((CAPACITY & (CAPACITY - 1)) == 0, "Capacity must be a power of two");
+public:
+    bool tryPush(const T* items, size_t count) {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        if (CAPACITY - (tail - headCache_) < count) {
+            headCache_ = head_.load(std::memory_order_acquire);
+            if (CAPACITY - (tail - headCache_) < count) return false;
         }
+        for (size_t i = 0; i < count; ++i) slots_[(tail + i) & (CAPACITY - 1)] = items[i];
+        tail_.store(tail + count, std::memory_order_release);
+        return true;
+    }
+    // Consumer: calls apply(item) on everything published so far. Returns the number of items.
+    template <typename Apply>
+    size_t drain(Apply&& apply) {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        const size_t tail = tail_.load(std::memory_order_acquire);
+        for (size_t i = head; i != tail; ++i) apply(slots_[i & (CAPACITY - 1)]);
+        head_.store(tail, std::memory_order_release);
+        return tail - head;
+    }
+private:
+    alignas(64) std::atomic<size_t> head_{0}; // Consumer
+    alignas(64) std::atomic<size_t> tail_{0}; // Producer
+    size_t headCache_ = 0;                    // Producer
+    alignas(64) T slots_[CAPACITY];
+};
 
-        // Normalize coefficients to sum to 1.0 to ensure gain is preserved
-        if (std::abs(sumCoeffs) > 1e-6) { // Avoid division by zero if all coeffs are zero
-            for (int i = 0; i < NUM_TAPS; ++i) {
-                sincTable[j][i] /= sumCoeffs;
-            }
+// One slot of the engine's voice pool: a playhead, rate, gain and loop state over a shared
+// AudioSample. Voices are preallocated by the engine and only ever retargeted, never created
+// or destroyed while the stream runs.
+//
+// Playback state belongs to the audio thread and is only changed by EngineCommands applied at the
+// top of a callback, so it is read without atomics. The control thread keeps its own bookkeeping
+// for allocation and learns that a voice has finished through finishedGeneration.
+struct Voice {
+    // Audio thread
+    const AudioSample* sample = nullptr; // Immutable; owned by the engine (see AudioEngine::voiceSamples_)
+    bool active = false; // Rendered at all; cleared when a voice that is not reserved finishes
+    bool isPlaying = false;
+    bool loop = false;
+    bool playOnceThenLoopSilently = false;
+    bool playedOnce = false;
+    int64_t playhead = 0; // 32.32 fixed-point frame position (see PLAYHEAD_FRACTION_BITS)
+    float rate = 1.0f; // Used unless useEngineRateForPlayback_ is set
+    float gain = 1.0f;
+    AudioEngine* audioEnginePtr = nullptr;
+    bool useEngineRateForPlayback_ = false;
+    uint32_t appliedGeneration_ = 0; // Generation of the last StartVoice applied
+    void start(const EngineCommand& command);
+
+    // Control thread. A voice that is not reserved is free once finished().
+    bool reserved = false; // Held by an engine role (platter, music) for its lifetime; never stolen. Set before the stream starts.
+    VoicePriority priority = VoicePriority::OneShot;
+    uint64_t startSequence = 0; // Start order, for oldest-first stealing
+    uint32_t generation = 0; // Bumped on every start
+    bool controlPlaying = false; // Last play state the control thread asked for
+    bool finished() const { return finishedGeneration.load(std::memory_order_acquire) == generation; }
+    bool isPlayingForControl() const { return controlPlaying && !finished(); }
+
+    // Written by the audio thread when the voice stops by itself
+    alignas(64) std::atomic<uint32_t> finishedGeneration{0};
+
+    static void logKernelLatency(const char* name, const SincKernelTable& kernel);
+
+    // Source -> stream channel mapping. The specialized layouts convolve each source channel once
+    // and fan it out; Generic keeps the per-output-channel 'ch_out % channels' loop.
+    enum class ChannelLayout { Generic, MonoToMono, MonoToStereo, StereoToMono, StereoToStereo };
+
+    // Where a span reads from: frame x of channel ch is planes[ch][x - originFrame] when planar
+    // (planes16 for PlanarInt16), or sample ch of frame x - originFrame of 'frames' when interleaved
+    struct SourceView {
+        const float* const* planes;
+        int32_t originFrame;
+        SampleFormat format = SampleFormat::PlanarFloat;
+        const void* frames = nullptr;
+        const int16_t* const* planes16 = nullptr;
+    };
+    // Kernel over channel CHANNEL of a CHANNELS-channel source, window starting at view frame
+    // 'windowStart'; the Generic layout passes CHANNELS == 0 and the channel at run time
+    template <int TAPS, SampleFormat FORMAT, int CHANNELS, int CHANNEL>
+    static float convolveSource(SourceView source, int32_t windowStart, const float* coeffs, int numTaps,
+                                int channels = CHANNELS, int channel = CHANNEL);
+    template <SampleFormat FORMAT>
+    static float sourceSample(SourceView source, int32_t channels, int channel, int32_t frame);
+    // Unity-rate copy of 'frames' frames from 'startFrame' on, with the gain ramp
+    template <SampleFormat FORMAT>
+    void mixUnitySpan(SourceView source, int32_t startFrame, int32_t frames, float* out, int32_t outputStreamChannels,
+                      float gain, float gainStep) const;
+
+    // Per-voice kernel tier and channel layout, bound to a specialized renderer whenever the voice
+    // starts a sample. Renders 'frames' output frames from 'source' (a planar, guard-padded
+    // level whose frames are 2^levelShift level-0 frames long), starting at level-0 fixed-point
+    // playhead 'position' and advancing by 'rate' (same format). Returns the new playhead.
+    // TAPS == 0 takes the tap count from 'kernel' at run time; CUBIC ignores 'kernel' and uses
+    // catmullRomCoefficients. FORMAT is the source's sample format; there is a renderer for each.
+    // The gain starts at 'gain' and moves by 'gainStep' per frame.
+    template <int TAPS, ChannelLayout LAYOUT, bool CUBIC = false, SampleFormat FORMAT = SampleFormat::PlanarFloat>
+    int64_t renderSpan(const SincKernelTable& kernel, SourceView source, int levelShift, int64_t position, int64_t rate,
+                       int32_t frames, float* out, int32_t outputStreamChannels, float gain, float gainStep) const;
+    using SpanRenderer = int64_t (Voice::*)(const SincKernelTable&, SourceView, int, int64_t, int64_t,
+                                            int32_t, float*, int32_t, float, float) const;
+    InterpolationQuality interpolationQuality = InterpolationQuality::Taps16;
+    KernelShape kernelShape = KernelShape::LinearPhase;
+    int32_t outputChannelCount = 2; // Stream channel count the renderers are specialized for
+    ChannelLayout channelLayout_ = ChannelLayout::Generic;
+    int32_t sourceChannels_ = 0;
+    // Indexed by SampleFormat
+    SpanRenderer renderSpan_[NUM_SAMPLE_FORMATS] = {};
+    SpanRenderer antiAliasRenderSpan_[NUM_SAMPLE_FORMATS] = {}; // Run-time tap count, for the anti-aliasing banks
+    SpanRenderer catmullRomRenderSpan_[NUM_SAMPLE_FORMATS] = {};
+    const SincKernelTable* kernel_ = nullptr;
+    void bindRenderer(int32_t sourceChannels);
+    template <ChannelLayout LAYOUT> void bindRendererForLayout();
+    template <ChannelLayout LAYOUT, SampleFormat FORMAT> void bindRendererForFormat();
+    // Run-time tap count and Generic layout, for a stream whose layout differs from the bound one
+    static SpanRenderer genericRenderSpan(SampleFormat format);
+
+    // Streamed sources (see StreamingSource). Source frames [streamWindowFirst_,
+    // streamWindowFirst_ + streamWindowFilled_) sit at the start of streamWindow_, which the engine
+    // preallocates for the music voice. Returns the playhead up to which every kernel read is
+    // covered: the end of the track once the stream is drained, else GUARD_FRAMES short of the
+    // window's last frame.
+    PlanarBuffer streamWindow_;
+    int64_t streamWindowFirst_ = 0;
+    int32_t streamWindowFilled_ = 0;
+    int64_t refillStreamWindow(StreamingSource& stream, int64_t position, bool& drained);
+
+    // Sinc/Catmull-Rom selection, driven by the engine from the audio thread. While
+    // modeCrossfadeFramesLeft_ > 0 the output blends fadingFromMode_ into interpolationMode_.
+    InterpolationMode interpolationMode_ = InterpolationMode::Sinc;
+    InterpolationMode fadingFromMode_ = InterpolationMode::Sinc;
+    int32_t modeCrossfadeFramesLeft_ = 0;
+    void setInterpolationMode(InterpolationMode mode);
+    SpanRenderer rendererForMode(InterpolationMode mode, SampleFormat format) const {
+        const int f = static_cast<int>(format);
+        return mode == InterpolationMode::CatmullRom ? catmullRomRenderSpan_[f] : renderSpan_[f];
+    }
+
+    // Wider, lower-cutoff kernel for |rate| > 1, or nullptr at or below unity
+    static const SincKernelTable* antiAliasBankForRate(float absRate);
+
+    void getAudio(float* outputBuffer, int32_t numOutputFrames, int32_t outputStreamChannels, float effectiveVolume);
+    // Stops the voice, reports it to the control thread and, unless an engine role holds it,
+    // hands it back to the pool
+    void finish();
+
+    // Number of consecutive output frames, starting at fixed-point 'position' and advancing by
+    // 'rate', whose playhead stays inside [lower, upper). At least 1, at most maxFrames.
+    static int32_t framesWithin(int64_t position, int64_t rate, int64_t lower, int64_t upper, int32_t maxFrames);
+
+    // Catmull-Rom cubic written as a 4-tap kernel over frames -1..2 around the playhead:
+    // 0.5 * (2p1 + (-p0 + p2)t + (2p0 - 5p1 + 4p2 - p3)t^2 + (-p0 + 3p1 - 3p2 + p3)t^3), regrouped per
+    // tap and evaluated lane-wise in Horner form so the loop compiles to one vector polynomial.
+    static inline void catmullRomCoefficients(uint32_t fraction, float* out) {
+        static constexpr float k0[4] = {0.0f, 1.0f, 0.0f, 0.0f};
+        static constexpr float k1[4] = {-0.5f, 0.0f, 0.5f, 0.0f};
+        static constexpr float k2[4] = {1.0f, -2.5f, 2.0f, -0.5f};
+        static constexpr float k3[4] = {-0.5f, 1.5f, -1.5f, 0.5f};
+        const float t = static_cast<float>(fraction) * (1.0f / 4294967296.0f);
+        for (int i = 0; i < 4; ++i) out[i] = ((k3[i] * t + k2[i]) * t + k1[i]) * t + k0[i];
+    }
+};
+// Reports how far a kernel's output lags the playhead. Group delay (measured at the half-frame
+// phase, where the kernel is furthest from a plain copy) is what the listener hears as latency;
+// lookahead is how many frames past the playhead the kernel reads, which only costs latency when
+// those frames are not already in memory.
+void Voice::logKernelLatency(const char* name, const SincKernelTable& kernel) {
+    alignas(64) float c[MAX_KERNEL_TAPS];
+    kernel.interpolate(uint32_t(1) << 31, c);
+    const double normalizedFrequencies[] = {0.0, 0.05, 0.2, 0.4}; // Cycles per frame
+    double groupDelay[4];
+    for (int k = 0; k < 4; ++k) {
+        // tau(w) = Re(sum n c[n] e^-iwn / sum c[n] e^-iwn), with n the lag of each tap behind the playhead
+        const double w = 2.0 * M_PI * normalizedFrequencies[k];
+        double hr = 0.0, hi = 0.0, nhr = 0.0, nhi = 0.0;
+        for (int i = 0; i < kernel.taps; ++i) {
+            const double n = kernel.centreTap + 0.5 - i;
+            hr += c[i] * std::cos(w * n); hi -= c[i] * std::sin(w * n);
+            nhr += n * c[i] * std::cos(w * n); nhi -= n * c[i] * std::sin(w * n);
         }
+        groupDelay[k] = (nhr * hr + nhi * hi) / (hr * hr + hi * hi);
+    }
+    ALOGI("Kernel latency [%s, %d taps]: group delay %.3f / %.3f / %.3f / %.3f frames at 0 / 0.05 / 0.2 / 0.4 cycles per frame, lookahead %d frames",
+          name, kernel.taps, groupDelay[0], groupDelay[1], groupDelay[2], groupDelay[3], kernel.taps - 1 - kernel.centreTap);
+}
+
+const SincKernelTable* Voice::antiAliasBankForRate(float absRate) {
+    if (absRate <= 1.0f) return nullptr;
+    for (const SincKernelTable& bank : ANTI_ALIAS_BANKS) {
+        if (absRate <= bank.rateScale) return &bank;
     }
-    sincTableInitialized = true;
-    ALOGI("Sinc table precalculated: %d steps, %d taps. Beta: %f", SUBDIVISION_STEPS, NUM_TAPS, KAISER_BETA);
+    return &ANTI_ALIAS_BANKS[NUM_ANTI_ALIAS_BANKS - 1]; // Beyond the widest bank: best effort
 }
 
 
 class AudioEngine : public oboe::AudioStreamCallback {
 public:
-    std::atomic<float> platterTargetPlaybackRate_{1.0f};
+    // Control-thread state: read and written only by the JNI entry points, never by the callback
     std::atomic<float> scratchSensitivity_{0.17f};
     const float MOVEMENT_THRESHOLD = 0.001f;
     float degreesPerFrameForUnityRate_ = 2.5f; // Default, will be updated from Kotlin
@@ -205,14 +1199,11 @@ public:
         ALOGI("AudioEngine default constructor.");
         currentPlatterSampleIndex_.store(0);
         currentMusicTrackIndex_.store(0);
-        platterFaderVolume_.store(0.0f);
-        generalMusicVolume_.store(0.9f);
-        isFingerDownOnPlatter_.store(false);
-        platterTargetPlaybackRate_.store(1.0f);
         scratchSensitivity_.store(0.17f);
 
         platterSamplePaths_ = {"sounds/haahhh", "sounds/sample1", "sounds/sample2"};
         musicTrackPaths_    = {"tracks/trackA", "tracks/trackB"};
+        for (std::atomic<LoadState>& state : loadState_) state.store(LoadState::Idle);
         ALOGI("AudioEngine Constructor: Initial scratchSensitivity_ set to %.4f", scratchSensitivity_.load());
     }
 
@@ -231,6 +1222,17 @@ public:
     void setMusicMasterVolumeInternal(float volume);
     void scratchPlatterActiveInternal(bool isActiveTouch, float angleDeltaOrRateFromViewModel);
     void releasePlatterTouchInternal();
+    // The platter and music entry points above only queue their loads and return; poll this to
+    // learn when the latest one for a target has been installed or has failed
+    LoadState loadState(LoadTarget target) const { return loadState_[static_cast<int>(target)].load(std::memory_order_acquire); }
+    void setSampleCacheBudgetInternal(size_t bytes) {
+        ALOGI("AudioEngine: Sample cache budget set to %zu KB", bytes / 1024);
+        sampleCache_.setByteBudget(bytes);
+    }
+    SampleCache::Stats sampleCacheStats() const { return sampleCache_.stats(); }
+    // How many upcoming platter samples and music tracks to prefetch, and whether to keep the
+    // previous one decoded too. 0 and false turn prefetching off.
+    void setPrefetchDepthInternal(int depth, bool includePrevious);
     void setScratchSensitivityInternal(float sensitivity) {
         ALOGI("AudioEngine: Setting scratch sensitivity from JNI to %.4f", sensitivity);
         scratchSensitivity_.store(sensitivity);
@@ -249,25 +1251,129 @@ public:
     void onErrorBeforeClose(oboe::AudioStream *stream, oboe::Result error) override;
     void onErrorAfterClose(oboe::AudioStream *stream, oboe::Result error) override;
 
-    // Getter for isFingerDownOnPlatter_
-    bool isPlatterTouched() const { return isFingerDownOnPlatter_.load(); }
+    void setPowerSaveModeInternal(bool enabled) {
+        ALOGI("AudioEngine: Power-save mode %s", enabled ? "on" : "off");
+        EngineCommand command;
+        command.type = EngineCommand::Type::SetPowerSaveMode;
+        command.enabled = enabled;
+        pushCommands({command});
+    }
+
+    // Audio thread: the platter state as of the commands applied so far
+    bool isPlatterTouched() const { return mix_.fingerDownOnPlatter; }
+    float platterTargetPlaybackRate() const { return mix_.platterTargetPlaybackRate; }
 
 private:
     std::shared_ptr<oboe::AudioStream> audioStream_;
     AAssetManager* appAssetManager_ = nullptr;
     uint32_t streamSampleRate_ = 0;
-    std::unique_ptr<AudioSample> platterAudioSample_;
-    std::unique_ptr<AudioSample> musicAudioSample_;
+    // Voice pool. voiceSamples_[i] owns the sample voices_[i] plays; the callback only ever holds
+    // a raw pointer to it, handed over in a StartVoice command.
+    Voice voices_[MAX_VOICES];
+    std::shared_ptr<AudioSample> voiceSamples_[MAX_VOICES];
+    uint64_t voiceStartSequence_ = 0;
+    Voice* platterVoice_ = nullptr; // Reserved for the platter and music roles at init
+    Voice* musicVoice_ = nullptr;
+    int voiceIndex(const Voice* voice) const { return static_cast<int>(voice - voices_); }
+    Voice* acquireVoice(VoicePriority priority);
+    EngineCommand prepareStart(Voice* voice, std::shared_ptr<AudioSample> sample);
+    std::shared_ptr<AudioSample> loadSample(const std::string& basePath, bool buildMipmapPyramid, bool convertToOutputRate, bool storeAsInt16);
+    std::shared_ptr<AudioSample> openStreamedSample(const std::string& basePath);
+    SampleCache sampleCache_{SAMPLE_CACHE_BYTE_BUDGET};
+    std::shared_ptr<AudioSample> loadSampleCached(const std::string& basePath, bool buildMipmapPyramid, bool convertToOutputRate,
+                                                  bool storeAsInt16);
     std::vector<std::string> platterSamplePaths_;
     std::atomic<int> currentPlatterSampleIndex_;
     std::vector<std::string> musicTrackPaths_;
     std::atomic<int> currentMusicTrackIndex_;
-    std::atomic<float> platterFaderVolume_;
-    std::atomic<float> generalMusicVolume_;
-    std::atomic<bool> isFingerDownOnPlatter_;
+
+    // Mixer state read by the callback. Only applyCommand writes it, on the audio thread, so the
+    // render path reads plain fields.
+    struct MixState {
+        float platterTargetPlaybackRate = 1.0f;
+        float platterFaderVolume = 0.0f;
+        float generalMusicVolume = 0.9f;
+        bool fingerDownOnPlatter = false;
+        bool powerSaveMode = false;
+    };
+    alignas(64) MixState mix_;
+
+    // The control thread's copy of the platter controls. Every change is sent as a complete
+    // PlatterControl command, so the callback never sees half of a scratch update.
+    struct PlatterControlState {
+        bool fingerDown = false;
+        bool useEngineRate = false;
+        bool playing = false;
+        float rate = 1.0f;
+    };
+    PlatterControlState platterControl_;
+    EngineCommand platterControlCommand() const;
+    EngineCommand voicePlayingCommand(Voice* voice, bool playing);
+
+    // JNI threads -> callback. Producers are serialized by commandProducerMutex_, which the
+    // callback never takes; onAudioReady drains the queue before it renders.
+    SpscQueue<EngineCommand, COMMAND_QUEUE_CAPACITY> commandQueue_;
+    std::mutex commandProducerMutex_;
+    uint64_t commandsPushed_ = 0; // Guarded by commandProducerMutex_
+    alignas(64) std::atomic<uint64_t> commandsApplied_{0}; // Published by the callback after each drain
+    bool pushCommands(std::initializer_list<EngineCommand> commands);
+    void applyCommand(const EngineCommand& command);
+
+    // Deferred reclamation of samples taken out of a voice. The callback may still be playing one
+    // until it applies the StartVoice that replaced it, so prepareStart parks it in
+    // replacedVoiceSamples_, pushCommands stamps it with that command's position in the queue, and
+    // loaderThread_ frees it once commandsApplied_ has passed it: tearing a sample down can unmap
+    // memory and join its threads, which neither the audio thread nor a touch event should wait
+    // for. retiredSamples_ is guarded by commandProducerMutex_.
+    struct RetiredSample {
+        std::shared_ptr<AudioSample> sample;
+        uint64_t reclaimAfter; // Queue position of the replacing command
+    };
+    std::shared_ptr<AudioSample> replacedVoiceSamples_[MAX_VOICES];
+    std::vector<RetiredSample> retiredSamples_;
+    void reclaimRetiredSamples();
+
+    // Serializes the control-side state (voice bookkeeping, voiceSamples_, platterControl_) between
+    // the JNI threads and loaderThread_. The callback never takes it.
+    std::mutex controlMutex_;
+
+    // Background decoding. The platter and music entry points queue a LoadRequest and return at
+    // once; loaderThread_ decodes it and installs the result through the command queue, so it
+    // lands at a block boundary. A newer request for the same target supersedes older ones.
+    enum class LoadAction { PlatterIntro, PlatterLoop, MusicPlay, MusicKeepState };
+    struct LoadRequest {
+        LoadAction action;
+        LoadTarget target;
+        uint32_t sequence; // Equals loadSequence_[target] while this is the latest request
+        std::string basePath;
+    };
+    std::thread loaderThread_;
+    std::mutex loaderMutex_;
+    std::condition_variable loaderCondition_;
+    std::deque<LoadRequest> loadRequests_;          // Guarded by loaderMutex_
+    bool loaderStopping_ = false;                   // Guarded by loaderMutex_
+    bool prefetchPending_ = false;                  // Guarded by loaderMutex_; the neighbours may need decoding
+    bool reclaimPending_ = false;                   // Guarded by loaderMutex_; retired samples may be reclaimable
+    std::atomic<int> prefetchDepth_{DEFAULT_PREFETCH_DEPTH};
+    std::atomic<bool> prefetchPrevious_{DEFAULT_PREFETCH_PREVIOUS};
+    uint32_t loadSequence_[NUM_LOAD_TARGETS] = {};  // Guarded by loaderMutex_
+    std::atomic<LoadState> loadState_[NUM_LOAD_TARGETS];
+    void requestLoad(LoadAction action, const std::string& basePath);
+    void loaderThreadMain();
+    void stopLoader();
+    bool finishLoad(const LoadRequest& request, LoadState state);
+    void installLoadedSample(const LoadRequest& request, std::shared_ptr<AudioSample> sample);
+    void prefetchNeighbours();
+    static bool buildsMipmaps(LoadTarget target) { return target == LoadTarget::Platter && BUILD_PLATTER_MIPMAPS; }
+    static bool convertsRate(LoadTarget target) {
+        return target == LoadTarget::Platter ? CONVERT_PLATTER_SAMPLE_RATE_ON_LOAD : CONVERT_MUSIC_SAMPLE_RATE_ON_LOAD;
+    }
+    static bool storesInt16(LoadTarget target) {
+        return target == LoadTarget::Platter ? STORE_PLATTER_SAMPLES_AS_INT16 : STORE_MUSIC_SAMPLES_AS_INT16;
+    }
 };
 
-// ... (AudioSample methods: hasExtension, tryLoadPath, load, getAudio - Catmull-Rom version) ...
+// ... (AudioSample methods: hasExtension, progressive decode, load; Voice methods: renderers, getAudio) ...
 bool AudioSample::hasExtension(const std::string& path, const std::string& extension) {
     if (path.length() >= extension.length()) {
         std::string lowerFilePath = path;
@@ -278,64 +1384,971 @@ bool AudioSample::hasExtension(const std::string& path, const std::string& exten
     return false;
 }
 
-bool AudioSample::tryLoadPath(AAssetManager* assetManager, const std::string& currentPathToTry) {
-    audioData.clear(); totalFrames = 0; channels = 0; sampleRate = 0; bool success = false;
-    AAsset* asset = AAssetManager_open(assetManager, currentPathToTry.c_str(), AASSET_MODE_BUFFER);
+// Whether asset directory 'directory' holds a file 'name'. The assets cannot change under a
+// running app, so each directory is listed once and the listing kept.
+static bool assetListed(AAssetManager* assetManager, const std::string& directory, const std::string& name) {
+    static std::mutex listingsMutex;
+    static std::unordered_map<std::string, std::vector<std::string>> listings;
+    std::lock_guard<std::mutex> lock(listingsMutex);
+    auto listing = listings.find(directory);
+    if (listing == listings.end()) {
+        std::vector<std::string> names;
+        if (AAssetDir* dir = AAssetManager_openDir(assetManager, directory.c_str())) {
+            while (const char* fileName = AAssetDir_getNextFileName(dir)) names.emplace_back(fileName);
+            AAssetDir_close(dir);
+        }
+        listing = listings.emplace(directory, std::move(names)).first;
+    }
+    return std::find(listing->second.begin(), listing->second.end(), name) != listing->second.end();
+}
+
+std::string AudioSample::resolveAssetPath(AAssetManager* assetManager, const std::string& basePath) {
+    if (!assetManager) return {};
+    const size_t slash = basePath.rfind('/');
+    const std::string directory = slash == std::string::npos ? std::string() : basePath.substr(0, slash);
+    const std::string name = slash == std::string::npos ? basePath : basePath.substr(slash + 1);
+    if ((hasExtension(basePath, ".wav") || hasExtension(basePath, ".mp3")) && assetListed(assetManager, directory, name)) return basePath;
+    if (assetListed(assetManager, directory, name + ".mp3")) return basePath + ".mp3";
+    if (assetListed(assetManager, directory, name + ".wav")) return basePath + ".wav";
+    return {};
+}
+
+size_t AudioSample::residentBytes() const {
+    size_t bytes = audioData.bytes() + audioData16.bytes();
+    if (direct) bytes += direct->head.bytes() + direct->tail.bytes() + direct->mapping.lockedBytes();
+    if (decodedFrames.load(std::memory_order_acquire) >= totalFrames) bytes += loopSeam.bytes(); // Else still being built
+    const int levelsReady = mipmapLevelsReady.load(std::memory_order_acquire);
+    for (int level = 0; level < levelsReady; ++level) bytes += mipLevels[level].data.bytes() + mipLevels[level].loopSeam.bytes();
+    return bytes;
+}
+
+bool AssetMapping::open(AAssetManager* assetManager, const std::string& path, bool allowInflate) {
+    close();
+    AAsset* asset = AAssetManager_open(assetManager, path.c_str(), AASSET_MODE_UNKNOWN);
     if (!asset) return false;
-    const void* assetBuffer = AAsset_getBuffer(asset);
-    size_t assetLength = AAsset_getLength(asset);
-    if (!assetBuffer) { AAsset_close(asset); return false; }
-    if (hasExtension(currentPathToTry, ".wav")) {
-        drwav wav;
-        if (drwav_init_memory(&wav, assetBuffer, assetLength, nullptr)) {
-            channels = wav.channels; totalFrames = (int32_t)wav.totalPCMFrameCount; sampleRate = wav.sampleRate;
-            audioData.resize(totalFrames * channels);
-            success = (drwav_read_pcm_frames_f32(&wav, totalFrames, audioData.data()) == totalFrames);
-            drwav_uninit(&wav);
+    off64_t start = 0, length = 0;
+    const int fd = AAsset_openFileDescriptor64(asset, &start, &length); // Fails for compressed entries
+    if (fd >= 0 && mapFile(fd, start, static_cast<size_t>(length))) {
+        AAsset_close(asset);
+        return true;
+    }
+    const void* buffer = allowInflate ? AAsset_getBuffer(asset) : nullptr;
+    if (!buffer) { AAsset_close(asset); return false; }
+    ALOGW("AssetMapping: '%s' is compressed in the APK; decoding from an inflated copy", path.c_str());
+    asset_ = asset;
+    data_ = static_cast<const uint8_t*>(buffer);
+    size_ = static_cast<size_t>(AAsset_getLength64(asset));
+    return true;
+}
+
+bool AssetMapping::mapFile(int fd, int64_t offset, size_t length) {
+    // mmap wants a page-aligned offset; entries sit anywhere in the APK
+    const int64_t pageSize = sysconf(_SC_PAGESIZE);
+    const int64_t mapOffset = offset - offset % pageSize;
+    const size_t mapLength = length + static_cast<size_t>(offset - mapOffset);
+    void* base = length > 0 ? mmap(nullptr, mapLength, PROT_READ, MAP_PRIVATE, fd, static_cast<off_t>(mapOffset)) : MAP_FAILED;
+    ::close(fd); // The mapping holds its own reference to the file
+    if (base == MAP_FAILED) return false;
+    madvise(base, mapLength, MADV_SEQUENTIAL); // Decoders read front to back
+    mapBase_ = base;
+    mapLength_ = mapLength;
+    data_ = static_cast<const uint8_t*>(base) + (offset - mapOffset);
+    size_ = length;
+    return true;
+}
+
+std::atomic<size_t> AssetMapping::lockedTotal_{0};
+
+bool AssetMapping::lockResident(size_t offset, size_t length) {
+    if (lockedBase_ || offset + length > size_) return false;
+    const uintptr_t pageSize = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+    const uintptr_t first = reinterpret_cast<uintptr_t>(data_ + offset) & ~(pageSize - 1);
+    const uintptr_t last = (reinterpret_cast<uintptr_t>(data_ + offset + length) + pageSize - 1) & ~(pageSize - 1);
+    void* base = reinterpret_cast<void*>(first);
+    const size_t lockLength = static_cast<size_t>(last - first);
+    // Checked before anything is read ahead, so a range that cannot be locked costs no I/O
+    rlimit limit{};
+    if (getrlimit(RLIMIT_MEMLOCK, &limit) == 0 && limit.rlim_cur != RLIM_INFINITY &&
+        lockedTotal_.load() + lockLength > static_cast<size_t>(limit.rlim_cur)) {
+        static std::atomic<bool> loggedLimit{false};
+        if (!loggedLimit.exchange(true)) {
+            ALOGI("AssetMapping: %zu KB does not fit under RLIMIT_MEMLOCK (%zu KB); such data is decoded instead",
+                  lockLength / 1024, static_cast<size_t>(limit.rlim_cur) / 1024);
         }
-    } else if (hasExtension(currentPathToTry, ".mp3")) {
-        drmp3_config config; drmp3_uint64 pcmFrameCount;
-        float* pPcmFrames = drmp3_open_memory_and_read_pcm_frames_f32(assetBuffer, assetLength, &config, &pcmFrameCount, nullptr);
-        if (pPcmFrames) {
-            channels = config.channels; sampleRate = config.sampleRate; totalFrames = (int32_t)pcmFrameCount;
-            audioData.assign(pPcmFrames, pPcmFrames + (pcmFrameCount * channels));
-            drmp3_free(pPcmFrames, nullptr); success = true;
+        return false;
+    }
+    if (mapBase_) madvise(mapBase_, mapLength_, MADV_RANDOM); // A platter seeks anywhere
+    madvise(base, lockLength, MADV_WILLNEED);
+    if (mlock(base, lockLength) != 0) {
+        ALOGW("AssetMapping: Could not lock %zu KB in RAM (errno %d)", lockLength / 1024, errno);
+        return false;
+    }
+    lockedBase_ = base;
+    lockedLength_ = lockLength;
+    lockedTotal_ += lockLength;
+    return true;
+}
+
+void AssetMapping::close() {
+    if (lockedBase_) {
+        munlock(lockedBase_, lockedLength_);
+        lockedTotal_ -= lockedLength_;
+        lockedBase_ = nullptr;
+        lockedLength_ = 0;
+    }
+    if (mapBase_) { munmap(mapBase_, mapLength_); mapBase_ = nullptr; mapLength_ = 0; }
+    if (asset_) { AAsset_close(asset_); asset_ = nullptr; }
+    data_ = nullptr;
+    size_ = 0;
+}
+
+bool AssetDecoder::open(AAssetManager* assetManager, const std::string& path) {
+    close();
+    if (!mapping_.open(assetManager, path)) return false;
+    const void* assetBuffer = mapping_.data();
+    const size_t assetLength = mapping_.size();
+    seekPoints_.clear();
+    drmp3_uint64 frames = 0;
+    if (AudioSample::hasExtension(path, ".wav")) {
+        isMp3_ = false;
+        decoderOpen_ = drwav_init_memory(&wav_, assetBuffer, assetLength, nullptr);
+        if (decoderOpen_) { channels = wav_.channels; sampleRate = wav_.sampleRate; frames = wav_.totalPCMFrameCount; }
+    } else if (AudioSample::hasExtension(path, ".mp3")) {
+        isMp3_ = true;
+        decoderOpen_ = drmp3_init_memory(&mp3_, assetBuffer, assetLength, nullptr);
+        // Walks the frame headers without decoding, then rewinds
+        if (decoderOpen_) { channels = static_cast<int32_t>(mp3_.channels); sampleRate = mp3_.sampleRate; frames = drmp3_get_pcm_frame_count(&mp3_); }
+        // Layer III: 1152 samples per frame for MPEG-1, 576 for MPEG-2 and 2.5
+        mp3FrameSamples_ = sampleRate >= 32000 ? 1152 : 576;
+    }
+    totalFrames = static_cast<int32_t>(frames);
+    if (!decoderOpen_ || channels == 0 || sampleRate == 0 || totalFrames == 0) { close(); return false; }
+    return true;
+}
+
+int32_t AssetDecoder::read(float* interleaved, int32_t maxFrames) {
+    if (!decoderOpen_ || maxFrames <= 0) return 0;
+    return static_cast<int32_t>(isMp3_ ? drmp3_read_pcm_frames_f32(&mp3_, static_cast<drmp3_uint64>(maxFrames), interleaved)
+                                       : drwav_read_pcm_frames_f32(&wav_, static_cast<drwav_uint64>(maxFrames), interleaved));
+}
+
+void AssetDecoder::close() {
+    if (decoderOpen_) {
+        if (isMp3_) drmp3_uninit(&mp3_); else drwav_uninit(&wav_);
+        decoderOpen_ = false;
+    }
+    mapping_.close();
+}
+
+// Stream frame (encoder delay included) at which the MP3 frame at point.seekPosInBytes starts.
+// The point's own frame is preceded by mp3FramesToDiscard leading frames, the first of which
+// starts at seekPosInBytes; pcmFrameIndex - pcmFramesToDiscard is where the last of them starts.
+int64_t AssetDecoder::seekPointFrame(const drmp3_seek_point& point) const {
+    return static_cast<int64_t>(point.pcmFrameIndex - point.pcmFramesToDiscard) -
+           static_cast<int64_t>(std::max<int>(point.mp3FramesToDiscard - 1, 0)) * mp3FrameSamples_;
+}
+
+std::vector<int32_t> AssetDecoder::splitPoints(int32_t begin, int32_t end, int count, int32_t minFrames) {
+    std::vector<int32_t> splits;
+    if (!isMp3_ || !decoderOpen_ || count < 2 || end - begin < 2 * minFrames) return splits;
+    if (seekPoints_.empty()) {
+        // On a decoder of its own: mp3_ is mid-stream, and this walks the whole file
+        drmp3 scanner;
+        if (!drmp3_init_memory(&scanner, mapping_.data(), mapping_.size(), nullptr)) return splits;
+        drmp3_uint32 pointCount = MP3_SEEK_POINTS;
+        seekPoints_.resize(pointCount);
+        if (!drmp3_calculate_seek_points(&scanner, &pointCount, seekPoints_.data())) pointCount = 0;
+        seekPoints_.resize(pointCount);
+        drmp3_uninit(&scanner);
+    }
+    // Candidate boundaries: the frame each seek point's decoding starts from, as output frames
+    const int64_t delay = mp3_.delayInPCMFrames;
+    int32_t previous = begin;
+    for (int k = 1; k < count; ++k) {
+        const int64_t target = begin + static_cast<int64_t>(end - begin) * k / count;
+        int64_t best = -1;
+        for (const drmp3_seek_point& point : seekPoints_) {
+            const int64_t boundary = seekPointFrame(point) - delay;
+            if (boundary < previous + minFrames || boundary > end - minFrames) continue;
+            if (best < 0 || std::abs(boundary - target) < std::abs(best - target)) best = boundary;
         }
+        if (best < 0) break;
+        splits.push_back(static_cast<int32_t>(best));
+        previous = static_cast<int32_t>(best);
     }
-    AAsset_close(asset); return success;
+    return splits;
 }
 
-void AudioSample::load(AAssetManager* assetManager, const std::string& basePath, AudioEngine* engine) {
-    if (!sincTableInitialized) { // Ensure table is calculated, typically once per app run or if params change
-        precalculateSincTable();
+// Drives the frame decoder directly instead of seeking a drmp3. A frame whose main data begins in
+// a frame not yet seen (an empty bit reservoir) decodes to nothing, and drmp3 would not count it,
+// so after a seek its position drifts by whole frames. Here frames are counted by their headers
+// until the first one decodes; from then on the reservoir is whole and, as in sequential decoding,
+// only frames that produce samples count. The preroll also primes the overlap and synthesis
+// filter state, so the samples match a decode from the start of the file bit for bit.
+template <typename T>
+int32_t AssetDecoder::decodeRange(int32_t begin, int32_t end, BasicPlanarBuffer<T>& dest, const std::atomic<bool>& cancel) const {
+    if (!isMp3_ || !decoderOpen_ || begin >= end) return 0;
+    // Stream frames count the encoder delay that read() skips
+    const int64_t streamBegin = static_cast<int64_t>(begin) + mp3_.delayInPCMFrames;
+    const int64_t streamEnd = static_cast<int64_t>(end) + mp3_.delayInPCMFrames;
+    const uint8_t* data = mapping_.data();
+    const size_t limit = mp3_.streamLength == DRMP3_UINT64_MAX ? mapping_.size()
+                                                               : static_cast<size_t>(std::min<drmp3_uint64>(mapping_.size(), mp3_.streamLength));
+    size_t position = static_cast<size_t>(mp3_.streamStartOffset);
+    int64_t frame = 0;
+    for (const drmp3_seek_point& point : seekPoints_) {
+        const int64_t start = seekPointFrame(point);
+        if (start > streamBegin - static_cast<int64_t>(MP3_SEAM_PREROLL_FRAMES) * mp3FrameSamples_) break;
+        position = static_cast<size_t>(point.seekPosInBytes);
+        frame = start;
     }
-    this->audioEnginePtr = engine; ALOGI("AudioSample: Attempting to load base path: %s", basePath.c_str());
-    isPlaying.store(false); preciseCurrentFrame.store(0.0f); useEngineRateForPlayback_.store(false);
-    playedOnce = false; loop.store(false); playOnceThenLoopSilently = false;
-    if (!assetManager) { ALOGE("AudioSample: AssetManager is null for %s!", basePath.c_str()); return; }
-    bool loadedSuccessfully = false; std::string successfulPath;
-    if (hasExtension(basePath, ".wav") || hasExtension(basePath, ".mp3")) {
-        if (tryLoadPath(assetManager, basePath)) { loadedSuccessfully = true; successfulPath = basePath; }
+
+    drmp3dec decoder;
+    drmp3dec_init(&decoder);
+    drmp3_int16 pcm[DRMP3_MAX_SAMPLES_PER_FRAME];
+    bool primed = false;
+    int32_t written = 0;
+    while (frame < streamEnd && position < limit && !cancel.load(std::memory_order_relaxed)) {
+        drmp3dec_frame_info info;
+        const int samples = drmp3dec_decode_frame(&decoder, data + position, static_cast<int>(std::min<size_t>(limit - position, INT32_MAX)), pcm, &info);
+        if (info.frame_bytes == 0) break;
+        position += static_cast<size_t>(info.frame_bytes);
+        if (samples == 0) {
+            if (!primed) frame += mp3FrameSamples_;
+            continue;
+        }
+        if (!primed && frame + samples > streamBegin) {
+            ALOGW("AssetDecoder: No preroll before frame %d; the seam may not match", begin);
+        }
+        primed = true;
+        if (info.channels != channels) {
+            ALOGW("AssetDecoder: Channel count changed at frame %lld, stopping the segment", static_cast<long long>(frame - mp3_.delayInPCMFrames));
+            break;
+        }
+        // Same s16 -> float scaling as drmp3_read_pcm_frames_f32
+        const int64_t first = std::max(frame, streamBegin);
+        const int64_t last = std::min(frame + samples, streamEnd);
+        for (int64_t f = first; f < last; ++f) {
+            const drmp3_int16* in = pcm + static_cast<size_t>(f - frame) * channels;
+            for (int ch = 0; ch < channels; ++ch) {
+                dest.plane(ch)[f - mp3_.delayInPCMFrames] = toStoredSample<T>(static_cast<float>(in[ch]) * 0.000030517578125f);
+            }
+        }
+        if (last > first) written += static_cast<int32_t>(last - first);
+        frame += samples;
+    }
+    return written;
+}
+
+void AudioSample::DirectSource::readChannel(int channel, int32_t first, int32_t count, float* out) const {
+    const size_t start = static_cast<size_t>(first) * channels + channel;
+    if (format == SampleFormat::InterleavedInt16) {
+        const int16_t* in = static_cast<const int16_t*>(frames) + start;
+        for (int32_t i = 0; i < count; ++i) out[i] = in[static_cast<size_t>(i) * channels] * 0.000030517578125f; // As drwav_s16_to_f32
+    } else {
+        const float* in = static_cast<const float*>(frames) + start;
+        for (int32_t i = 0; i < count; ++i) out[i] = in[static_cast<size_t>(i) * channels];
+    }
+}
+
+bool AudioSample::openDirect(AAssetManager* assetManager, const std::string& path, bool convertToOutputRate) {
+    auto source = std::make_unique<DirectSource>();
+    if (!source->mapping.open(assetManager, path)) return false;
+    drwav wav;
+    if (!drwav_init_memory(&wav, source->mapping.data(), source->mapping.size(), nullptr)) return false;
+    const bool int16 = wav.translatedFormatTag == DR_WAVE_FORMAT_PCM && wav.bitsPerSample == 16;
+    const bool float32 = wav.translatedFormatTag == DR_WAVE_FORMAT_IEEE_FLOAT && wav.bitsPerSample == 32;
+    const int32_t fileChannels = wav.channels;
+    const uint32_t fileRate = wav.sampleRate;
+    const uint64_t fileFrames = wav.totalPCMFrameCount;
+    const uint64_t dataOffset = wav.dataChunkDataPos;
+    drwav_uninit(&wav);
+    const size_t bytesPerSample = int16 ? sizeof(int16_t) : sizeof(float);
+    const bool needsConversion = convertToOutputRate && outputSampleRate != 0 && fileRate != outputSampleRate;
+    // Too short for separate ends and seam, or a data chunk that runs past the file: decode instead
+    if ((!int16 && !float32) || needsConversion || fileChannels < 1 || fileFrames < static_cast<uint64_t>(LOOP_SEAM_FRAMES) ||
+        fileFrames > static_cast<uint64_t>(INT32_MAX) || dataOffset + fileFrames * fileChannels * bytesPerSample > source->mapping.size()) {
+        return false;
+    }
+    const uint8_t* data = source->mapping.data() + dataOffset;
+    if (reinterpret_cast<uintptr_t>(data) % bytesPerSample != 0) return false;
+    if (!source->mapping.lockResident(static_cast<size_t>(dataOffset), static_cast<size_t>(fileFrames * fileChannels * bytesPerSample))) {
+        return false;
+    }
+    source->frames = data;
+    source->format = int16 ? SampleFormat::InterleavedInt16 : SampleFormat::InterleavedFloat;
+    source->channels = fileChannels;
+
+    audioData.clear(); audioData16.clear();
+    channels = fileChannels;
+    sampleRate = fileRate;
+    totalFrames = static_cast<int32_t>(fileFrames);
+    source->head.allocate(channels, 2 * GUARD_FRAMES);
+    source->tail.allocate(channels, 2 * GUARD_FRAMES);
+    loopSeam.allocate(channels, LOOP_SEAM_FRAMES);
+    for (int ch = 0; ch < channels; ++ch) {
+        source->readChannel(ch, 0, 2 * GUARD_FRAMES, source->head.plane(ch));
+        source->readChannel(ch, totalFrames - 2 * GUARD_FRAMES, 2 * GUARD_FRAMES, source->tail.plane(ch));
+        // As buildLoopSeam: the last 2 * GUARD_FRAMES frames, then the first
+        std::copy_n(source->tail.plane(ch), 2 * GUARD_FRAMES, loopSeam.plane(ch));
+        std::copy_n(source->head.plane(ch), 2 * GUARD_FRAMES, loopSeam.plane(ch) + 2 * GUARD_FRAMES);
+    }
+    direct = std::move(source);
+    return true;
+}
+
+bool AudioSample::beginDecode(AAssetManager* assetManager, const std::string& path, bool convertToOutputRate, bool storeAsInt16) {
+    audioData.clear(); audioData16.clear(); totalFrames = 0; channels = 0; sampleRate = 0;
+    auto pending = std::make_unique<PendingDecode>();
+    pending->started = std::chrono::steady_clock::now();
+    if (!pending->decoder.open(assetManager, path)) return false;
+    const AssetDecoder& decoder = pending->decoder;
+    channels = decoder.channels;
+    sampleRate = decoder.sampleRate;
+    pending->sourceRate = decoder.sampleRate;
+    pending->sequentialEnd = decoder.totalFrames;
+    totalFrames = decoder.totalFrames;
+    if (convertToOutputRate && outputSampleRate != 0 && sampleRate != outputSampleRate) {
+        pending->converter = std::make_unique<RateConverter>(sampleRate, outputSampleRate);
+        pending->source.allocate(channels, decoder.totalFrames);
+        totalFrames = pending->converter->outputFrames(decoder.totalFrames);
+        sampleRate = outputSampleRate;
+    }
+    if (storeAsInt16) audioData16.allocate(channels, totalFrames);
+    else audioData.allocate(channels, totalFrames);
+    pending->chunk.resize(static_cast<size_t>(PROGRESSIVE_DECODE_CHUNK_FRAMES) * channels);
+    pending_ = std::move(pending);
+    return true;
+}
+
+bool AudioSample::decodeNextChunk() {
+    PendingDecode& pending = *pending_;
+    const int32_t wanted = std::min(PROGRESSIVE_DECODE_CHUNK_FRAMES, pending.sequentialEnd - pending.sourceDecoded);
+    const int32_t decoded = pending.decoder.read(pending.chunk.data(), wanted);
+    if (decoded > 0) {
+        withDecodeTarget([&](auto& target) { target.deinterleave(pending.chunk.data(), pending.sourceDecoded, decoded); });
+        pending.sourceDecoded += decoded;
     }
-    if (!loadedSuccessfully) {
-        std::string pathWithMp3 = basePath + ".mp3";
-        if (tryLoadPath(assetManager, pathWithMp3)) { loadedSuccessfully = true; successfulPath = pathWithMp3; }
+    if (decoded < wanted) {
+        // Ends only the sequential range: segment workers may still be writing the rest, and
+        // decodeRemainder publishes their ranges as they join
+        ALOGW("AudioSample: '%s' ended %d frames short of frame %d; the rest of that range is silence",
+              filePath.c_str(), pending.sequentialEnd - pending.sourceDecoded, pending.sequentialEnd);
+        pending.sourceDecoded = pending.sequentialEnd;
+    }
+    publishDecoded();
+    return pending.sourceDecoded < pending.sequentialEnd;
+}
+
+void AudioSample::publishDecoded(unsigned conversionThreads) {
+    PendingDecode& pending = *pending_;
+    const bool sourceDone = pending.sourceDecoded >= pending.decoder.totalFrames;
+    int32_t ready = sourceDone ? totalFrames : pending.sourceDecoded;
+    if (pending.converter) {
+        ready = sourceDone ? totalFrames : pending.converter->outputFramesCovered(pending.sourceDecoded);
+        if (ready > pending.converted) {
+            if (storedAsInt16()) pending.converter->convert(pending.source, audioData16, pending.converted, ready, conversionThreads, &finisherCancel_);
+            else pending.converter->convert(pending.source, audioData, pending.converted, ready, conversionThreads, &finisherCancel_);
+            if (finisherCancel_.load()) return; // The range may be incomplete; the sample is going away
+            pending.converted = ready;
+        }
     }
-    if (!loadedSuccessfully) {
-        std::string pathWithWav = basePath + ".wav";
-        if (tryLoadPath(assetManager, pathWithWav)) { loadedSuccessfully = true; successfulPath = pathWithWav; }
+    // The last frame waits for completeDecode(), which builds the loop seam first
+    decodedFrames.store(std::min(ready, totalFrames - 1), std::memory_order_release);
+}
+
+// Hands all but the first of up to MAX_PARALLEL_DECODE_THREADS ranges of what is left to worker
+// threads, and shortens the sequential decode to the first
+void AudioSample::startParallelDecode(std::vector<DecodeSegment>& segments) {
+    PendingDecode& pending = *pending_;
+    const int threads = static_cast<int>(std::min(std::thread::hardware_concurrency(), MAX_PARALLEL_DECODE_THREADS));
+    const std::vector<int32_t> splits = pending.decoder.splitPoints(pending.sourceDecoded, pending.sequentialEnd, threads,
+                                                                    MIN_PARALLEL_DECODE_SEGMENT_FRAMES);
+    if (splits.empty()) return;
+    segments.resize(splits.size()); // Not resized again: the workers hold on to their entries
+    withDecodeTarget([&](auto& target) {
+        for (size_t k = 0; k < splits.size(); ++k) {
+            DecodeSegment& segment = segments[k];
+            segment.begin = splits[k];
+            segment.end = k + 1 < splits.size() ? splits[k + 1] : pending.sequentialEnd;
+            segment.worker = std::thread([this, &pending, &target, &segment] {
+                segment.decoded = pending.decoder.decodeRange(segment.begin, segment.end, target, finisherCancel_);
+            });
+        }
+    });
+    ALOGI("AudioSample: Decoding '%s' from frame %d on %zu extra threads", filePath.c_str(), splits.front(), splits.size());
+    pending.sequentialEnd = splits.front();
+}
+
+void AudioSample::completeDecode() {
+    if (storedAsInt16()) buildLoopSeam(audioData16, loopSeam);
+    else buildLoopSeam(audioData, loopSeam);
+    const auto elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - pending_->started).count();
+    if (pending_->converter) {
+        ALOGI("AudioSample: Decoded '%s' and converted it from %u Hz to %u Hz (%d -> %d frames, %d taps) in %lld ms",
+              filePath.c_str(), pending_->sourceRate, sampleRate, pending_->source.frames, totalFrames,
+              pending_->converter->taps(), static_cast<long long>(elapsedMs));
+    } else {
+        ALOGI("AudioSample: Decoded '%s' (%d frames) in %lld ms", filePath.c_str(), totalFrames, static_cast<long long>(elapsedMs));
     }
+    pending_.reset();
+    decodedFrames.store(totalFrames, std::memory_order_release);
+}
+
+// Runs on loadFinisher_. Worker threads take the tail of an MP3 while this thread carries on
+// from the head, so the watermark keeps moving; their ranges are published in order as they join.
+void AudioSample::decodeRemainder(bool buildMipmapPyramid) {
+    if (pending_) {
+        std::vector<DecodeSegment> segments;
+        startParallelDecode(segments);
+        bool cancelled = false;
+        while (!cancelled && decodeNextChunk()) cancelled = finisherCancel_.load();
+        for (size_t k = 0; k < segments.size(); ++k) {
+            DecodeSegment& segment = segments[k];
+            segment.worker.join();
+            if (cancelled || finisherCancel_.load()) { cancelled = true; continue; }
+            if (segment.decoded < segment.end - segment.begin) {
+                ALOGW("AudioSample: '%s' decoded %d of frames [%d, %d); the rest is silence",
+                      filePath.c_str(), segment.decoded, segment.begin, segment.end);
+            }
+            pending_->sourceDecoded = segment.end;
+            // A whole segment at once: spread it over the cores the later segments leave free
+            const unsigned stillDecoding = static_cast<unsigned>(segments.size() - k - 1);
+            publishDecoded(MAX_SAMPLE_RATE_CONVERSION_THREADS > stillDecoding ? MAX_SAMPLE_RATE_CONVERSION_THREADS - stillDecoding : 1);
+        }
+        if (cancelled) return;
+        completeDecode();
+    }
+    if (buildMipmapPyramid) buildMipmaps();
+}
+
+void AudioSample::load(AAssetManager* assetManager, const std::string& basePath, bool buildMipmapPyramid, bool convertToOutputRate,
+                       bool storeAsInt16) {
+    stopLoadFinisher(); // The finisher writes audioData, which is about to be replaced
+    finisherCancel_.store(false); // The decode below checks it as well
+    mipmapLevelsReady.store(0);
+    decodedFrames.store(0);
+    pending_.reset();
+    direct.reset();
+    for (MipLevel& level : mipLevels) { level.data.clear(); level.loopSeam.clear(); }
+    ALOGI("AudioSample: Attempting to load base path: %s", basePath.c_str());
+    sourceRateRatio_ = 1.0;
+    if (!assetManager) { ALOGE("AudioSample: AssetManager is null for %s!", basePath.c_str()); return; }
+    const std::string successfulPath = resolveAssetPath(assetManager, basePath);
+    const bool playsInPlace = PLAY_WAV_IN_PLACE && hasExtension(successfulPath, ".wav") &&
+                              openDirect(assetManager, successfulPath, convertToOutputRate);
+    const bool loadedSuccessfully = playsInPlace || (!successfulPath.empty() && beginDecode(assetManager, successfulPath, convertToOutputRate, storeAsInt16));
     if (loadedSuccessfully) {
         this->filePath = successfulPath;
-        ALOGI("AudioSample: Successfully loaded '%s' (Frames: %d, Ch: %d, SR: %u Hz)", filePath.c_str(), totalFrames, channels, sampleRate);
+        if (outputSampleRate != 0 && sampleRate != 0) {
+            sourceRateRatio_ = static_cast<double>(sampleRate) / static_cast<double>(outputSampleRate);
+        }
+        if (playsInPlace) {
+            decodedFrames.store(totalFrames, std::memory_order_release);
+            ALOGI("AudioSample: Playing '%s' in place (Frames: %d, Ch: %d, SR: %u Hz, %s)", filePath.c_str(), totalFrames, channels,
+                  sampleRate, direct->format == SampleFormat::InterleavedInt16 ? "16-bit" : "float");
+        } else {
+            // Enough to start playing from; the rest is decoded behind the playhead's back
+            const int32_t syncFrames = static_cast<int32_t>(static_cast<int64_t>(sampleRate) * PROGRESSIVE_DECODE_SYNC_MS / 1000);
+            bool moreToDecode = true;
+            while (moreToDecode && decodedFrames.load(std::memory_order_relaxed) < syncFrames) moreToDecode = decodeNextChunk();
+            if (!moreToDecode) completeDecode();
+            ALOGI("AudioSample: Successfully loaded '%s' (Frames: %d, Ch: %d, SR: %u Hz, %s), %d frames decoded up front",
+                  filePath.c_str(), totalFrames, channels, sampleRate, storedAsInt16() ? "16-bit" : "float",
+                  decodedFrames.load(std::memory_order_relaxed));
+        }
+        if (pending_ || buildMipmapPyramid) {
+            loadFinisher_ = std::thread(&AudioSample::decodeRemainder, this, buildMipmapPyramid);
+        }
     } else {
         this->filePath = basePath; ALOGE("AudioSample: Failed to load audio for base '%s'", basePath.c_str());
-        audioData.clear(); totalFrames = 0; channels = 0; sampleRate = 0;
+        audioData.clear(); audioData16.clear(); loopSeam.clear(); totalFrames = 0; channels = 0; sampleRate = 0;
     }
 }
 
-void AudioSample::getAudio(float* outputBuffer, int32_t numOutputFrames, int32_t outputStreamChannels,
-                           float effectiveVolume) {
+size_t StreamingSource::onRead(void* userData, void* bufferOut, size_t bytesToRead) {
+    const int bytesRead = AAsset_read(static_cast<StreamingSource*>(userData)->asset_, bufferOut, bytesToRead);
+    return bytesRead > 0 ? static_cast<size_t>(bytesRead) : 0;
+}
+
+bool StreamingSource::seekAsset(void* userData, int offset, int whence) {
+    return AAsset_seek64(static_cast<StreamingSource*>(userData)->asset_, offset, whence) >= 0;
+}
+
+drmp3_bool32 StreamingSource::onSeekMp3(void* userData, int offset, drmp3_seek_origin origin) {
+    const int whence = origin == drmp3_seek_origin_start ? SEEK_SET : origin == drmp3_seek_origin_end ? SEEK_END : SEEK_CUR;
+    return seekAsset(userData, offset, whence) ? DRMP3_TRUE : DRMP3_FALSE;
+}
+
+drmp3_bool32 StreamingSource::onTellMp3(void* userData, drmp3_int64* cursor) {
+    const off64_t position = AAsset_seek64(static_cast<StreamingSource*>(userData)->asset_, 0, SEEK_CUR);
+    if (position < 0) return DRMP3_FALSE;
+    *cursor = position;
+    return DRMP3_TRUE;
+}
+
+drwav_bool32 StreamingSource::onSeekWav(void* userData, int offset, drwav_seek_origin origin) {
+    return seekAsset(userData, offset, origin == drwav_seek_origin_start ? SEEK_SET : SEEK_CUR) ? DRWAV_TRUE : DRWAV_FALSE;
+}
+
+bool StreamingSource::open(AAssetManager* assetManager, const std::string& path, int64_t firstFrame) {
+    close();
+    path_ = path;
+    const bool mapped = mapping_.open(assetManager, path, false);
+    if (!mapped) asset_ = AAssetManager_open(assetManager, path.c_str(), AASSET_MODE_STREAMING);
+    if (!mapped && !asset_) { ALOGE("StreamingSource: Could not open '%s'", path.c_str()); return false; }
+    isMp3_ = AudioSample::hasExtension(path, ".mp3");
+    if (isMp3_) {
+        decoderOpen_ = mapped ? drmp3_init_memory(&mp3_, mapping_.data(), mapping_.size(), nullptr)
+                              : drmp3_init(&mp3_, onRead, onSeekMp3, onTellMp3, nullptr, this, nullptr);
+        if (decoderOpen_) { channels = static_cast<int32_t>(mp3_.channels); sampleRate = mp3_.sampleRate; }
+    } else {
+        decoderOpen_ = mapped ? drwav_init_memory(&wav_, mapping_.data(), mapping_.size(), nullptr)
+                              : drwav_init(&wav_, onRead, onSeekWav, this, nullptr);
+        if (decoderOpen_) { channels = wav_.channels; sampleRate = wav_.sampleRate; }
+    }
+    if (!decoderOpen_ || channels < 1 || channels > 2) {
+        ALOGE("StreamingSource: Could not decode '%s' (Ch: %d)", path.c_str(), channels);
+        close();
+        return false;
+    }
+    if (firstFrame > 0) {
+        const bool sought = isMp3_ ? drmp3_seek_to_pcm_frame(&mp3_, static_cast<drmp3_uint64>(firstFrame))
+                                   : drwav_seek_to_pcm_frame(&wav_, static_cast<drwav_uint64>(firstFrame));
+        if (!sought) { ALOGW("StreamingSource: Seek to frame %lld failed in '%s'; starting at 0", (long long)firstFrame, path.c_str()); firstFrame = 0; }
+    }
+    startFrame = firstFrame;
+    ring_.assign(static_cast<size_t>(STREAM_RING_FRAMES) * channels, 0.0f);
+    decodeChunk_.assign(static_cast<size_t>(STREAM_DECODE_CHUNK_FRAMES) * channels, 0.0f);
+    readFrame_.store(0); writeFrame_.store(0);
+    endOfStream_.store(false); underruns_.store(0); stopping_.store(false);
+    // Queue enough that the first callback after the switch does not starve
+    while (writeFrame_.load(std::memory_order_relaxed) < static_cast<uint64_t>(STREAM_DECODE_AHEAD_FRAMES) && fill()) {}
+    producer_ = std::thread(&StreamingSource::produce, this);
+    ALOGI("StreamingSource: Streaming '%s' from frame %lld (Ch: %d, SR: %u Hz)", path.c_str(), (long long)startFrame, channels, sampleRate);
+    return true;
+}
+
+bool StreamingSource::fill() {
+    if (endOfStream_.load(std::memory_order_relaxed)) return false;
+    const uint64_t written = writeFrame_.load(std::memory_order_relaxed);
+    const uint64_t queued = written - readFrame_.load(std::memory_order_acquire);
+    if (queued >= static_cast<uint64_t>(STREAM_DECODE_AHEAD_FRAMES)) return false;
+    const int32_t space = STREAM_RING_FRAMES - static_cast<int32_t>(queued);
+    const int32_t wanted = std::min(STREAM_DECODE_CHUNK_FRAMES, space);
+    if (wanted <= 0) return false;
+    const int32_t decoded = static_cast<int32_t>(isMp3_
+        ? drmp3_read_pcm_frames_f32(&mp3_, static_cast<drmp3_uint64>(wanted), decodeChunk_.data())
+        : drwav_read_pcm_frames_f32(&wav_, static_cast<drwav_uint64>(wanted), decodeChunk_.data()));
+    // Copy into the ring in at most two runs around the wrap
+    const int32_t ringIndex = static_cast<int32_t>(written % STREAM_RING_FRAMES);
+    const int32_t firstRun = std::min(decoded, STREAM_RING_FRAMES - ringIndex);
+    std::copy_n(decodeChunk_.data(), static_cast<size_t>(firstRun) * channels, ring_.data() + static_cast<size_t>(ringIndex) * channels);
+    std::copy_n(decodeChunk_.data() + static_cast<size_t>(firstRun) * channels, static_cast<size_t>(decoded - firstRun) * channels, ring_.data());
+    writeFrame_.store(written + decoded, std::memory_order_release);
+    if (decoded < wanted) endOfStream_.store(true, std::memory_order_release);
+    return decoded > 0;
+}
+
+void StreamingSource::produce() {
+    while (!stopping_.load(std::memory_order_acquire)) {
+        if (!fill()) std::this_thread::sleep_for(std::chrono::milliseconds(STREAM_PRODUCER_POLL_MS));
+    }
+}
+
+int32_t StreamingSource::read(PlanarBuffer& window, int32_t firstFrame, int32_t maxFrames) {
+    const uint64_t readFrame = readFrame_.load(std::memory_order_relaxed);
+    const uint64_t available = writeFrame_.load(std::memory_order_acquire) - readFrame;
+    const int32_t frames = static_cast<int32_t>(std::min<uint64_t>(available, static_cast<uint64_t>(maxFrames)));
+    if (frames <= 0) return 0;
+    const int32_t ringIndex = static_cast<int32_t>(readFrame % STREAM_RING_FRAMES);
+    const int32_t firstRun = std::min(frames, STREAM_RING_FRAMES - ringIndex);
+    for (int ch = 0; ch < channels; ++ch) {
+        float* dst = window.plane(ch) + firstFrame;
+        const float* src = ring_.data() + static_cast<size_t>(ringIndex) * channels + ch;
+        for (int32_t f = 0; f < firstRun; ++f) dst[f] = src[static_cast<size_t>(f) * channels];
+        src = ring_.data() + ch;
+        for (int32_t f = firstRun; f < frames; ++f) dst[f] = src[static_cast<size_t>(f - firstRun) * channels];
+    }
+    readFrame_.store(readFrame + frames, std::memory_order_release);
+    return frames;
+}
+
+bool StreamingSource::drained() const {
+    return endOfStream_.load(std::memory_order_acquire) &&
+           readFrame_.load(std::memory_order_relaxed) == writeFrame_.load(std::memory_order_acquire);
+}
+
+void StreamingSource::close() {
+    stopping_.store(true, std::memory_order_release);
+    if (producer_.joinable()) producer_.join();
+    if (decoderOpen_) {
+        if (isMp3_) drmp3_uninit(&mp3_); else drwav_uninit(&wav_);
+        decoderOpen_ = false;
+        const uint32_t underruns = underruns_.load(std::memory_order_relaxed);
+        if (underruns > 0) ALOGW("StreamingSource: '%s' starved the callback %u time(s)", path_.c_str(), underruns);
+    }
+    if (asset_) { AAsset_close(asset_); asset_ = nullptr; }
+    mapping_.close();
+    ring_ = AlignedVector<float>();
+    decodeChunk_ = std::vector<float>();
+}
+
+void AudioSample::openStream(AAssetManager* assetManager, const std::string& path, int64_t firstFrame) {
+    stream = std::make_unique<StreamingSource>();
+    if (!assetManager || !stream->open(assetManager, path, firstFrame)) {
+        ALOGE("AudioSample: Failed to stream '%s'", path.c_str());
+        stream.reset();
+        filePath = path; channels = 0; sampleRate = 0;
+        return;
+    }
+    filePath = path;
+    channels = stream->channels;
+    sampleRate = stream->sampleRate;
+    sourceRateRatio_ = (outputSampleRate != 0 && sampleRate != 0)
+        ? static_cast<double>(sampleRate) / static_cast<double>(outputSampleRate) : 1.0;
+}
+
+RateConverter::RateConverter(uint32_t sourceRate, uint32_t destRate) : sourceRate_(sourceRate), destRate_(destRate) {
+    // Converting down lowers the cutoff to the new Nyquist; widen the kernel to keep its transition band
+    const float scale = std::max(1.0f, static_cast<float>(sourceRate) / static_cast<float>(destRate));
+    taps_ = std::min(((static_cast<int>(std::ceil(SAMPLE_RATE_CONVERSION_TAPS * scale)) + 7) / 8) * 8, MAX_KERNEL_TAPS);
+    kernel_ = buildSincKernel(kernelStorage_, taps_, SAMPLE_RATE_CONVERSION_PHASES, scale, SAMPLE_RATE_CONVERSION_BETA);
+}
+
+int32_t RateConverter::outputFramesCovered(int32_t sourceFrames) const {
+    // Output frame n reads source frames up to floor(n * sourceRate / destRate) - centreTap + taps
+    const int64_t lastBaseFrame = static_cast<int64_t>(sourceFrames) + kernel_.centreTap - taps_;
+    if (lastBaseFrame < 0) return 0;
+    return static_cast<int32_t>(static_cast<uint64_t>(lastBaseFrame) * destRate_ / sourceRate_);
+}
+
+template <typename T>
+void RateConverter::convertRange(const PlanarBuffer& source, BasicPlanarBuffer<T>& dest, int32_t begin, int32_t end,
+                                 const std::atomic<bool>* cancel) const {
+    const int32_t channels = dest.channelCount();
+    alignas(64) float coefficients[MAX_KERNEL_TAPS];
+    for (int32_t n = begin; n < end; ++n) {
+        if ((n - begin) % FINISHER_CANCEL_CHECK_FRAMES == 0 && cancel && cancel->load(std::memory_order_relaxed)) return;
+        // Source position n * sourceRate / destRate, split into integer frame and 0.32 fraction
+        const uint64_t scaledPosition = static_cast<uint64_t>(n) * sourceRate_;
+        const int32_t baseFrameIndex = static_cast<int32_t>(scaledPosition / destRate_);
+        const uint32_t fraction = static_cast<uint32_t>(((scaledPosition % destRate_) << PLAYHEAD_FRACTION_BITS) / destRate_);
+        kernel_.interpolate(fraction, coefficients);
+        const int32_t windowStart = baseFrameIndex - kernel_.centreTap;
+        for (int ch = 0; ch < channels; ++ch) {
+            dest.plane(ch)[n] = toStoredSample<T>(convolveTaps(source.plane(ch) + windowStart, coefficients, taps_));
+        }
+    }
+}
+
+template <typename T>
+void RateConverter::convert(const PlanarBuffer& source, BasicPlanarBuffer<T>& dest, int32_t begin, int32_t end,
+                            unsigned maxThreads, const std::atomic<bool>* cancel) const {
+    const int32_t frames = end - begin;
+    if (frames <= 0) return;
+    const unsigned numThreads = std::max(1u, std::min({std::thread::hardware_concurrency(), MAX_SAMPLE_RATE_CONVERSION_THREADS, maxThreads}));
+    const int32_t framesPerThread = (frames + static_cast<int32_t>(numThreads) - 1) / static_cast<int32_t>(numThreads);
+    std::vector<std::thread> workers;
+    for (unsigned t = 1; t < numThreads; ++t) {
+        const int32_t workerBegin = std::min(end, begin + static_cast<int32_t>(t) * framesPerThread);
+        workers.emplace_back(&RateConverter::convertRange<T>, this, std::cref(source), std::ref(dest),
+                             workerBegin, std::min(end, workerBegin + framesPerThread), cancel);
+    }
+    convertRange(source, dest, begin, std::min(end, begin + framesPerThread), cancel);
+    for (std::thread& worker : workers) worker.join();
+}
+
+// Picks the channel layout from the voice's sample and the stream, then the tap-specialized renderer
+void Voice::bindRenderer(int32_t sourceChannels) {
+    kernel_ = &(kernelShape == KernelShape::LowDelay ? LOW_DELAY_TABLES : SINC_TABLES)[static_cast<int>(interpolationQuality)];
+    sourceChannels_ = sourceChannels;
+    channelLayout_ = ChannelLayout::Generic;
+    if (sourceChannels == 1 && outputChannelCount == 1) channelLayout_ = ChannelLayout::MonoToMono;
+    else if (sourceChannels == 1 && outputChannelCount == 2) channelLayout_ = ChannelLayout::MonoToStereo;
+    else if (sourceChannels == 2 && outputChannelCount == 1) channelLayout_ = ChannelLayout::StereoToMono;
+    else if (sourceChannels == 2 && outputChannelCount == 2) channelLayout_ = ChannelLayout::StereoToStereo;
+    switch (channelLayout_) {
+        case ChannelLayout::Generic:        bindRendererForLayout<ChannelLayout::Generic>();        break;
+        case ChannelLayout::MonoToMono:     bindRendererForLayout<ChannelLayout::MonoToMono>();     break;
+        case ChannelLayout::MonoToStereo:   bindRendererForLayout<ChannelLayout::MonoToStereo>();   break;
+        case ChannelLayout::StereoToMono:   bindRendererForLayout<ChannelLayout::StereoToMono>();   break;
+        case ChannelLayout::StereoToStereo: bindRendererForLayout<ChannelLayout::StereoToStereo>(); break;
+    }
+}
+
+template <Voice::ChannelLayout LAYOUT>
+void Voice::bindRendererForLayout() {
+    bindRendererForFormat<LAYOUT, SampleFormat::PlanarFloat>();
+    bindRendererForFormat<LAYOUT, SampleFormat::InterleavedFloat>();
+    bindRendererForFormat<LAYOUT, SampleFormat::InterleavedInt16>();
+    bindRendererForFormat<LAYOUT, SampleFormat::PlanarInt16>();
+}
+
+template <Voice::ChannelLayout LAYOUT, SampleFormat FORMAT>
+void Voice::bindRendererForFormat() {
+    const int f = static_cast<int>(FORMAT);
+    antiAliasRenderSpan_[f] = &Voice::renderSpan<0, LAYOUT, false, FORMAT>;
+    catmullRomRenderSpan_[f] = &Voice::renderSpan<4, LAYOUT, true, FORMAT>;
+    switch (interpolationQuality) {
+        case InterpolationQuality::Taps4:  renderSpan_[f] = &Voice::renderSpan<4, LAYOUT, false, FORMAT>;  break;
+        case InterpolationQuality::Taps8:  renderSpan_[f] = &Voice::renderSpan<8, LAYOUT, false, FORMAT>;  break;
+        case InterpolationQuality::Taps16: renderSpan_[f] = &Voice::renderSpan<16, LAYOUT, false, FORMAT>; break;
+        case InterpolationQuality::Taps32: renderSpan_[f] = &Voice::renderSpan<32, LAYOUT, false, FORMAT>; break;
+        case InterpolationQuality::Taps64: renderSpan_[f] = &Voice::renderSpan<64, LAYOUT, false, FORMAT>; break;
+    }
+}
+
+Voice::SpanRenderer Voice::genericRenderSpan(SampleFormat format) {
+    switch (format) {
+        case SampleFormat::InterleavedFloat: return &Voice::renderSpan<0, ChannelLayout::Generic, false, SampleFormat::InterleavedFloat>;
+        case SampleFormat::InterleavedInt16: return &Voice::renderSpan<0, ChannelLayout::Generic, false, SampleFormat::InterleavedInt16>;
+        case SampleFormat::PlanarInt16:      return &Voice::renderSpan<0, ChannelLayout::Generic, false, SampleFormat::PlanarInt16>;
+        default:                             return &Voice::renderSpan<0, ChannelLayout::Generic, false, SampleFormat::PlanarFloat>;
+    }
+}
+
+template <int TAPS, SampleFormat FORMAT, int CHANNELS, int CHANNEL>
+float Voice::convolveSource(SourceView source, int32_t windowStart, const float* coeffs, int numTaps, int channels, int channel) {
+    if constexpr (FORMAT == SampleFormat::PlanarFloat) {
+        return convolveTaps<TAPS>(source.planes[channel] + windowStart, coeffs, numTaps);
+    } else if constexpr (FORMAT == SampleFormat::PlanarInt16) {
+        // Every layout reads one plane at unit stride, widening as it loads
+        return convolveFrameTaps<TAPS, 1, 0>(source.planes16[channel] + windowStart, coeffs, numTaps);
+    } else {
+        using Sample = std::conditional_t<FORMAT == SampleFormat::InterleavedInt16, int16_t, float>;
+        const Sample* frames = static_cast<const Sample*>(source.frames) + static_cast<ptrdiff_t>(windowStart) * channels;
+        if constexpr (CHANNELS == 0) return convolveStridedTaps<TAPS>(frames + channel, channels, coeffs, numTaps);
+        else return convolveFrameTaps<TAPS, CHANNELS, CHANNEL>(frames, coeffs, numTaps);
+    }
+}
+
+template <SampleFormat FORMAT>
+float Voice::sourceSample(SourceView source, int32_t channels, int channel, int32_t frame) {
+    if constexpr (FORMAT == SampleFormat::PlanarFloat) {
+        return source.planes[channel][frame - source.originFrame];
+    } else if constexpr (FORMAT == SampleFormat::PlanarInt16) {
+        return fromStoredSample(source.planes16[channel][frame - source.originFrame]);
+    } else {
+        const size_t index = static_cast<size_t>(frame - source.originFrame) * channels + channel;
+        if constexpr (FORMAT == SampleFormat::InterleavedInt16) return static_cast<const int16_t*>(source.frames)[index] * (1.0f / 32768.0f);
+        else return static_cast<const float*>(source.frames)[index];
+    }
+}
+
+template <SampleFormat FORMAT>
+void Voice::mixUnitySpan(SourceView source, int32_t startFrame, int32_t frames, float* out, int32_t outputStreamChannels,
+                         float gain, float gainStep) const {
+    for (int ch_out = 0; ch_out < outputStreamChannels; ++ch_out) {
+        const int channel = ch_out % sourceChannels_;
+        for (int32_t f = 0; f < frames; ++f) {
+            out[f * outputStreamChannels + ch_out] += sourceSample<FORMAT>(source, sourceChannels_, channel, startFrame + f) *
+                                                      (gain + gainStep * static_cast<float>(f));
+        }
+    }
+}
+
+// Starts a crossfade to 'mode'. Reversing a fade in progress continues from the current blend.
+void Voice::setInterpolationMode(InterpolationMode mode) {
+    if (mode == interpolationMode_) return;
+    modeCrossfadeFramesLeft_ = modeCrossfadeFramesLeft_ > 0 ? INTERPOLATION_CROSSFADE_FRAMES - modeCrossfadeFramesLeft_
+                                                            : INTERPOLATION_CROSSFADE_FRAMES;
+    fadingFromMode_ = interpolationMode_;
+    interpolationMode_ = mode;
+}
+
+template <int TAPS, Voice::ChannelLayout LAYOUT, bool CUBIC, SampleFormat FORMAT>
+int64_t Voice::renderSpan(const SincKernelTable& kernel, SourceView source, int levelShift, int64_t position, int64_t rate,
+                          int32_t frames, float* out, int32_t outputStreamChannels, float gain, float gainStep) const {
+    static_assert(!CUBIC || TAPS == 4, "The Catmull-Rom kernel has 4 taps");
+    const int kernelTaps = TAPS > 0 ? TAPS : kernel.taps;
+    const int centreTap = CUBIC ? 1 : kernel.centreTap;
+    for (int32_t f = 0; f < frames; ++f) {
+        const int64_t levelPosition = position >> levelShift;
+        const uint32_t fractionalTime = static_cast<uint32_t>(levelPosition);
+        const int32_t baseFrameIndex = static_cast<int32_t>(levelPosition >> PLAYHEAD_FRACTION_BITS);
+
+        // Coefficients for this exact fractional offset, shared by every output channel
+        alignas(64) float coefficients[TAPS > 0 ? TAPS : MAX_KERNEL_TAPS];
+        if constexpr (CUBIC) catmullRomCoefficients(fractionalTime, coefficients);
+        else kernel.interpolate(fractionalTime, coefficients);
+
+        // If fractionalTime = 0, the peak of the kernel (tap centreTap) lands on baseFrameIndex,
+        // so the window starts centreTap frames before it.
+        const int32_t windowStart = baseFrameIndex - centreTap - source.originFrame;
+        const float frameGain = gain + gainStep * static_cast<float>(f);
+
+        if constexpr (LAYOUT == ChannelLayout::MonoToMono) {
+            out[f] += convolveSource<TAPS, FORMAT, 1, 0>(source, windowStart, coefficients, kernelTaps) * frameGain;
+        } else if constexpr (LAYOUT == ChannelLayout::StereoToMono) {
+            // Stereo -> mono keeps the left channel, as the generic ch_out % channels mapping does
+            out[f] += convolveSource<TAPS, FORMAT, 2, 0>(source, windowStart, coefficients, kernelTaps) * frameGain;
+        } else if constexpr (LAYOUT == ChannelLayout::MonoToStereo) {
+            const float sample = convolveSource<TAPS, FORMAT, 1, 0>(source, windowStart, coefficients, kernelTaps) * frameGain;
+            out[2 * f] += sample;
+            out[2 * f + 1] += sample;
+        } else if constexpr (LAYOUT == ChannelLayout::StereoToStereo) {
+            out[2 * f] += convolveSource<TAPS, FORMAT, 2, 0>(source, windowStart, coefficients, kernelTaps) * frameGain;
+            out[2 * f + 1] += convolveSource<TAPS, FORMAT, 2, 1>(source, windowStart, coefficients, kernelTaps) * frameGain;
+        } else {
+            for (int ch_out = 0; ch_out < outputStreamChannels; ++ch_out) {
+                int srcChannel = ch_out % sourceChannels_; // Handle mono-to-stereo, etc.
+                float interpolatedSample = convolveSource<TAPS, FORMAT, 0, 0>(source, windowStart, coefficients, kernelTaps,
+                                                                               sourceChannels_, srcChannel);
+                out[f * outputStreamChannels + ch_out] += interpolatedSample * frameGain;
+            }
+        }
+        position += rate;
+    }
+    return position;
+}
+
+template <typename T>
+void AudioSample::buildLoopSeam(const BasicPlanarBuffer<T>& data, PlanarBuffer& seam) {
+    const int32_t numFrames = data.frames;
+    if (numFrames == 0) { seam.clear(); return; }
+    seam.allocate(data.channelCount(), LOOP_SEAM_FRAMES);
+    for (int ch = 0; ch < data.channelCount(); ++ch) {
+        const T* src = data.plane(ch);
+        float* dst = seam.plane(ch);
+        // Seam frame k is sample frame numFrames - 2 * GUARD_FRAMES + k, wrapped into [0, numFrames)
+        for (int32_t k = 0; k < LOOP_SEAM_FRAMES; ++k) {
+            dst[k] = fromStoredSample(src[((numFrames - 2 * GUARD_FRAMES + k) % numFrames + numFrames) % numFrames]);
+        }
+    }
+}
+
+void AudioSample::stopLoadFinisher() {
+    if (loadFinisher_.joinable()) {
+        finisherCancel_.store(true);
+        loadFinisher_.join();
+    }
+}
+
+// Runs on loadFinisher_, after the decode. Each level is the previous one low-passed at half its Nyquist and
+// decimated by 2; a level is published (release) only after all of its frames and its loop seam
+// are written.
+void AudioSample::buildMipmaps() {
+    float halfBand[HALF_BAND_TAPS];
+    fillWindowedSinc(halfBand, HALF_BAND_TAPS, 0.0, 0.5);
+    constexpr int centreTap = HALF_BAND_TAPS / 2 - 1;
+
+    const PlanarBuffer* src = &audioData;
+    std::vector<float> levelZeroChannel; // Level 0 of a sample played in place or stored as 16-bit, a channel at a time
+    for (int levelIndex = 0; levelIndex < MIPMAP_LEVELS; ++levelIndex) {
+        if (finisherCancel_.load()) return;
+        MipLevel& level = mipLevels[levelIndex];
+        const int32_t srcFrames = levelIndex == 0 ? totalFrames : src->frames;
+        const int32_t dstFrames = (srcFrames + 1) / 2;
+        if (dstFrames < HALF_BAND_TAPS) break; // Too short to be worth decimating further
+        level.data.allocate(channels, dstFrames);
+        for (int ch = 0; ch < channels; ++ch) {
+            const float* in = nullptr;
+            if (levelIndex == 0 && (direct || storedAsInt16())) {
+                levelZeroChannel.resize(static_cast<size_t>(srcFrames));
+                if (direct) {
+                    direct->readChannel(ch, 0, srcFrames, levelZeroChannel.data());
+                } else {
+                    const int16_t* stored = audioData16.plane(ch);
+                    for (int32_t f = 0; f < srcFrames; ++f) levelZeroChannel[f] = fromStoredSample(stored[f]);
+                }
+                in = levelZeroChannel.data();
+            } else {
+                in = src->plane(ch);
+            }
+            float* dst = level.data.plane(ch);
+            for (int32_t m = 0; m < dstFrames; ++m) {
+                if (m % FINISHER_CANCEL_CHECK_FRAMES == 0 && finisherCancel_.load(std::memory_order_relaxed)) return;
+                const int32_t first = 2 * m - centreTap;
+                const int32_t kBegin = std::max(0, -first);
+                const int32_t kEnd = std::min(HALF_BAND_TAPS, srcFrames - first); // Outside the sample counts as silence
+                float acc = 0.0f;
+                for (int32_t k = kBegin; k < kEnd; ++k) acc += halfBand[k] * in[first + k];
+                dst[m] = acc;
+            }
+        }
+        buildLoopSeam(level.data, level.loopSeam);
+        mipmapLevelsReady.store(levelIndex + 1, std::memory_order_release);
+        src = &level.data;
+    }
+    ALOGI("AudioSample: Mipmap pyramid for '%s' ready (%d levels)", filePath.c_str(), mipmapLevelsReady.load());
+}
+
+void Voice::start(const EngineCommand& command) {
+    sample = command.sample;
+    appliedGeneration_ = command.generation;
+    active = true;
+    isPlaying = command.playing;
+    const StreamingSource* stream = sample ? sample->stream.get() : nullptr;
+    loop = command.loop && !stream; // Streams play forwards once
+    playOnceThenLoopSilently = command.playOnceThenLoop && !stream;
+    playedOnce = false;
+    playhead = stream ? stream->startFrame << PLAYHEAD_FRACTION_BITS : 0;
+    streamWindowFirst_ = stream ? stream->startFrame : 0;
+    streamWindowFilled_ = 0;
+    gain = command.value;
+    rate = command.rate;
+    useEngineRateForPlayback_ = command.useEngineRate;
+    modeCrossfadeFramesLeft_ = 0; // Nothing of the previous sample to fade from
+    // Bound on every start: a replaced sample is freed, so a new one may reuse its address
+    if (sample) bindRenderer(sample->channels);
+}
+
+int64_t Voice::refillStreamWindow(StreamingSource& stream, int64_t position, bool& drained) {
+    const int32_t capacity = streamWindow_.frames;
+    const int32_t channels = stream.channels;
+    // Slide the window forward once it is three-quarters full, keeping GUARD_FRAMES of history
+    // behind the playhead for the kernel
+    if (streamWindowFilled_ > capacity - capacity / 4) {
+        const int64_t keepFirst = std::max(streamWindowFirst_, (position >> PLAYHEAD_FRACTION_BITS) - GUARD_FRAMES);
+        const int32_t drop = static_cast<int32_t>(std::min<int64_t>(keepFirst - streamWindowFirst_, streamWindowFilled_));
+        if (drop > 0) {
+            for (int ch = 0; ch < channels; ++ch) {
+                float* plane = streamWindow_.plane(ch);
+                std::memmove(plane, plane + drop, static_cast<size_t>(streamWindowFilled_ - drop) * sizeof(float));
+            }
+            streamWindowFirst_ += drop;
+            streamWindowFilled_ -= drop;
+        }
+    }
+    if (streamWindowFilled_ < capacity) {
+        streamWindowFilled_ += stream.read(streamWindow_, streamWindowFilled_, capacity - streamWindowFilled_);
+    }
+    drained = stream.drained();
+    const int64_t windowEnd = streamWindowFirst_ + streamWindowFilled_;
+    if (drained) {
+        // The kernel reads up to GUARD_FRAMES past the last frame; make that silence, as it is for a sample
+        for (int ch = 0; ch < channels; ++ch) {
+            std::fill_n(streamWindow_.plane(ch) + streamWindowFilled_, GUARD_FRAMES, 0.0f);
+        }
+        return windowEnd << PLAYHEAD_FRACTION_BITS;
+    }
+    return (windowEnd - GUARD_FRAMES) << PLAYHEAD_FRACTION_BITS;
+}
+
+void Voice::finish() {
+    isPlaying = false;
+    if (!reserved) active = false;
+    finishedGeneration.store(appliedGeneration_, std::memory_order_release);
+}
+
+int32_t Voice::framesWithin(int64_t position, int64_t rate, int64_t lower, int64_t upper, int32_t maxFrames) {
+    int64_t frames;
+    if (rate > 0) {
+        frames = (upper - position + rate - 1) / rate;
+    } else if (rate < 0) {
+        frames = (position - lower) / -rate + 1;
+    } else {
+        return maxFrames;
+    }
+    if (frames >= maxFrames) return maxFrames;
+    return static_cast<int32_t>(std::max<int64_t>(1, frames));
+}
+
+void Voice::getAudio(float* outputBuffer, int32_t numOutputFrames, int32_t outputStreamChannels,
+                     float effectiveVolume) {
+    const AudioSample* s = sample;
+
     bool doLog = false;
     bool isPlatterTouched_engine = false;
     if (audioEnginePtr != nullptr) {
@@ -345,29 +2358,31 @@ void AudioSample::getAudio(float* outputBuffer, int32_t numOutputFrames, int32_t
         }
     }
 
-    float localPreciseCurrentFrame = preciseCurrentFrame.load();
-    float playbackRateToUse = 1.0f;
+    int64_t localPlayhead = playhead;
+    float playbackRateToUse = rate;
 
-    if (useEngineRateForPlayback_.load() && audioEnginePtr != nullptr) {
-        playbackRateToUse = audioEnginePtr->platterTargetPlaybackRate_.load();
+    if (useEngineRateForPlayback_ && audioEnginePtr != nullptr) {
+        playbackRateToUse = audioEnginePtr->platterTargetPlaybackRate();
     }
+    const double sourceRateRatio = s ? s->sourceRateRatio_ : 1.0;
+    const int64_t playbackIncrement = playheadFromFrames(playbackRateToUse * sourceRateRatio);
 
     if (doLog) {
         // Variables for logging, matching the requested items
-        const char* log_filePath = this->filePath.c_str(); // Item 1
-        float log_initialFrame = localPreciseCurrentFrame;    // Item 2
-        bool log_isPlaying = isPlaying.load();              // Item 3
-        bool log_useEngineRate = useEngineRateForPlayback_.load(); // Item 4
+        const char* log_filePath = s ? s->filePath.c_str() : ""; // Item 1
+        double log_initialFrame = playheadToFrames(localPlayhead); // Item 2
+        bool log_isPlaying = isPlaying;              // Item 3
+        bool log_useEngineRate = useEngineRateForPlayback_; // Item 4
         bool log_enginePtrValid = (audioEnginePtr != nullptr); // Item 5
         // Item 6a (isPlatterTouched_engine) is already available
         float log_enginePlatterRate = -1.0f; // Item 6b (placeholder if not applicable)
         if (log_useEngineRate && audioEnginePtr != nullptr) {
-            log_enginePlatterRate = audioEnginePtr->platterTargetPlaybackRate_.load();
+            log_enginePlatterRate = audioEnginePtr->platterTargetPlaybackRate();
         }
         // Item 7 (playbackRateToUse) is already available
-        int log_totalFrames = this->totalFrames; // For context
+        int log_totalFrames = s ? s->totalFrames : 0; // For context
 
-        ALOGV("AudioSample::getAudio[%s] FingerDown:%d - StartFrame:%.2f, isPlaying:%d, useEngineRate:%d, enginePtrValid:%d, enginePlatterRate:%.2f, finalPlaybackRate:%.2f, totalFrames:%d",
+        ALOGV("Voice::getAudio[%s] FingerDown:%d - StartFrame:%.2f, isPlaying:%d, useEngineRate:%d, enginePtrValid:%d, enginePlatterRate:%.2f, finalPlaybackRate:%.2f, totalFrames:%d",
               log_filePath,
               isPlatterTouched_engine, // This is the direct result of audioEnginePtr->isPlatterTouched()
               log_initialFrame,
@@ -380,90 +2395,164 @@ void AudioSample::getAudio(float* outputBuffer, int32_t numOutputFrames, int32_t
     }
 
     // Standard checks for playability
-    if (!isPlaying.load() || audioData.empty() || totalFrames == 0 || channels == 0) {
+    if (!isPlaying || !s || !s->playable() || s->channels == 0 || (s->stream && streamWindow_.empty())) {
         if (doLog) { // Log if returning early during a finger-down scenario
-            ALOGV("AudioSample::getAudio[%s] FingerDown:%d - RETURNING EARLY. isPlaying:%d, audioEmpty:%d, totalFrames:%d, channels:%d. Frame:%.2f",
-                  this->filePath.c_str(), isPlatterTouched_engine, isPlaying.load(), audioData.empty(), totalFrames, channels, localPreciseCurrentFrame);
+            ALOGV("Voice::getAudio[%s] FingerDown:%d - RETURNING EARLY. isPlaying:%d, hasSample:%d, totalFrames:%d. Frame:%.2f",
+                  s ? s->filePath.c_str() : "", isPlatterTouched_engine, isPlaying, s != nullptr, s ? s->totalFrames : 0,
+                  playheadToFrames(localPlayhead));
         }
         return;
     }
 
     // Main processing loop
-    // localPreciseCurrentFrame will be modified within this loop
-    for (int i = 0; i < numOutputFrames; ++i) {
-        if (!isPlaying.load()) {
-            if (doLog) ALOGV("AudioSample::getAudio[%s] FingerDown:%d - Loop iter %d: Breaking loop, isPlaying is false. Frame: %.2f", this->filePath.c_str(), isPlatterTouched_engine, i, localPreciseCurrentFrame);
+    // The callback is split into spans during which the playhead cannot leave [0, totalFrames),
+    // nor move between the loop seam and the body of the sample while looping.
+    // Wrapping/stopping is only decided between spans; inside a span the guard padding (or the
+    // seam) makes every kernel read valid, so the inner loops carry no boundary checks.
+    // A streamed source is read from streamWindow_, topped up before every span; its spans end
+    // where the window's decoded frames do. A sample still being decoded ends GUARD_FRAMES short of
+    // its watermark; a playhead that catches up waits there, silent, neither wrapping nor stopping.
+    // A WAV played in place has no guard padding, so within GUARD_FRAMES of either end its spans
+    // read from the planar copies of its ends instead, as a looping voice reads from the seam.
+    // localPlayhead will be modified within this loop
+    int64_t endPlayhead = static_cast<int64_t>(s->totalFrames) << PLAYHEAD_FRACTION_BITS;
+    StreamingSource* const stream = s->stream.get();
+    const AudioSample::DirectSource* const direct = s->direct.get();
+    SourceView body = direct               ? SourceView{nullptr, 0, direct->format, direct->frames}
+                      : s->storedAsInt16() ? SourceView{nullptr, 0, SampleFormat::PlanarInt16, nullptr, s->audioData16.framePtrs.data()}
+                                           : SourceView{s->audioData.framePtrs.data(), 0};
+    const int32_t decodedFrames = stream ? 0 : s->decodedFrames.load(std::memory_order_acquire);
+    const bool decoding = !stream && decodedFrames < s->totalFrames;
+    if (decoding) endPlayhead = static_cast<int64_t>(std::max(0, decodedFrames - GUARD_FRAMES)) << PLAYHEAD_FRACTION_BITS;
+    int i = 0;
+    while (i < numOutputFrames) {
+        if (!isPlaying) {
+            if (doLog) ALOGV("Voice::getAudio[%s] FingerDown:%d - Loop iter %d: Breaking loop, isPlaying is false. Frame: %.2f", s->filePath.c_str(), isPlatterTouched_engine, i, playheadToFrames(localPlayhead));
             break;
         }
+        if (stream) {
+            bool drained = false;
+            endPlayhead = refillStreamWindow(*stream, localPlayhead, drained);
+            body = {streamWindow_.framePtrs.data(), static_cast<int32_t>(streamWindowFirst_)};
+            if (localPlayhead >= endPlayhead && !drained) {
+                // The decoder has fallen behind; the rest of the block stays silent
+                stream->noteUnderrun();
+                break;
+            }
+        }
+
+        if (decoding && (localPlayhead >= endPlayhead || (localPlayhead < 0 && loop))) {
+            break; // Caught up with the decoder; the tail (and the loop seam) are not there yet
+        }
 
         // Boundary logic
-        if (localPreciseCurrentFrame >= static_cast<float>(totalFrames) || localPreciseCurrentFrame < 0.0f) {
+        if (localPlayhead >= endPlayhead || localPlayhead < 0) {
             if (playOnceThenLoopSilently && !playedOnce) {
-                if (doLog) ALOGV("AudioSample::getAudio[%s] FingerDown:%d - Loop iter %d: playOnceThenLoopSilently path. Frame: %.2f", this->filePath.c_str(), isPlatterTouched_engine, i, localPreciseCurrentFrame);
-                playedOnce = true; localPreciseCurrentFrame = 0.0f;
-                if (!loop.load()) loop.store(true);
-            } else if (loop.load()) {
-                if (totalFrames > 0) {
-                    if (doLog && (localPreciseCurrentFrame >= static_cast<float>(totalFrames) || localPreciseCurrentFrame < 0.0f)) {
-                         ALOGV("AudioSample::getAudio[%s] FingerDown:%d - Loop iter %d: Looping frame. Before: %.2f", this->filePath.c_str(), isPlatterTouched_engine, i, localPreciseCurrentFrame);
-                    }
-                    localPreciseCurrentFrame = fmodf(localPreciseCurrentFrame, static_cast<float>(totalFrames));
-                    if (localPreciseCurrentFrame < 0.0f) localPreciseCurrentFrame += static_cast<float>(totalFrames);
-                    if (doLog && (localPreciseCurrentFrame >= static_cast<float>(totalFrames) || localPreciseCurrentFrame < 0.0f)) { // Should ideally not happen after correction
-                         ALOGV("AudioSample::getAudio[%s] FingerDown:%d - Loop iter %d: Looping frame. After: %.2f", this->filePath.c_str(), isPlatterTouched_engine, i, localPreciseCurrentFrame);
-                    }
-                } else {
-                     localPreciseCurrentFrame = 0.0f;
-                }
+                if (doLog) ALOGV("Voice::getAudio[%s] FingerDown:%d - Loop iter %d: playOnceThenLoopSilently path. Frame: %.2f", s->filePath.c_str(), isPlatterTouched_engine, i, playheadToFrames(localPlayhead));
+                playedOnce = true; localPlayhead = 0;
+                loop = true;
+            } else if (loop) {
+                if (doLog) ALOGV("Voice::getAudio[%s] FingerDown:%d - Loop iter %d: Looping frame. Before: %.2f", s->filePath.c_str(), isPlatterTouched_engine, i, playheadToFrames(localPlayhead));
+                localPlayhead %= endPlayhead;
+                if (localPlayhead < 0) localPlayhead += endPlayhead;
             } else { // Not looping, and beyond boundaries
-                if (doLog) ALOGV("AudioSample::getAudio[%s] FingerDown:%d - Loop iter %d: End of non-looping sample. Setting isPlaying=false. Frame: %.2f", this->filePath.c_str(), isPlatterTouched_engine, i, localPreciseCurrentFrame);
-                isPlaying.store(false);
-                break; 
+                if (doLog) ALOGV("Voice::getAudio[%s] FingerDown:%d - Loop iter %d: End of non-looping sample. Setting isPlaying=false. Frame: %.2f", s->filePath.c_str(), isPlatterTouched_engine, i, playheadToFrames(localPlayhead));
+                finish();
+                break;
             }
         }
-        
-        if (!isPlaying.load()) { // Re-check after boundary logic might have changed isPlaying
-             if (doLog) ALOGV("AudioSample::getAudio[%s] FingerDown:%d - Loop iter %d: Breaking loop (post-boundary logic), isPlaying is false. Frame: %.2f", this->filePath.c_str(), isPlatterTouched_engine, i, localPreciseCurrentFrame);
-             break;
-        }
 
-        float fractionalTime = localPreciseCurrentFrame - std::floor(localPreciseCurrentFrame);
-        int32_t baseFrameIndex = static_cast<int32_t>(std::floor(localPreciseCurrentFrame));
-
-        // Determine index for sincTable lookup
-        int sincTableIndex = static_cast<int>(fractionalTime * SUBDIVISION_STEPS);
-        sincTableIndex = std::min(sincTableIndex, SUBDIVISION_STEPS - 1); // Clamp to max index
-
-        const std::vector<float>& coefficients = sincTable[sincTableIndex];
-
-        // Calculate start index for fetching samples for the convolution kernel
-        // The kernel is centered around a point "just before" baseFrameIndex if fractionalTime is 0.
-        // More precisely, for fractionalTime = 0, we want the output to be as close as possible
-        // to the sample at baseFrameIndex.
-        // The coefficients are indexed 0 to NUM_TAPS-1.
-        // If fractionalTime = 0, sincPoint for tap i is (i - (NUM_TAPS/2 - 1)).
-        // The peak of the sinc function (sincPoint=0) is when i = NUM_TAPS/2 - 1.
-        // So, coefficients[NUM_TAPS/2 - 1] should be multiplied by sample at baseFrameIndex.
-        // Thus, the first sample in our local kernel (kernelSamples[0]) should correspond to
-        // baseFrameIndex - (NUM_TAPS/2 - 1).
-        int32_t kernelStartFrameIndex = baseFrameIndex - (NUM_TAPS / 2 - 1);
-
-        for (int ch_out = 0; ch_out < outputStreamChannels; ++ch_out) {
-            int srcChannel = ch_out % channels; // Handle mono-to-stereo, etc.
-            float interpolatedSample = 0.0f;
-
-            // Collect samples for the convolution
-            // This loop can be optimized by fetching all NUM_TAPS samples first if beneficial
-            // but direct use of getSampleAt handles boundaries per sample.
-            for (int k = 0; k < NUM_TAPS; ++k) {
-                float sampleValue = getSampleAt(kernelStartFrameIndex + k, srcChannel);
-                interpolatedSample += sampleValue * coefficients[k];
+        const bool looping = loop && !decoding;
+        int32_t spanFrames = framesWithin(localPlayhead, playbackIncrement, 0, endPlayhead, numOutputFrames - i);
+        if (modeCrossfadeFramesLeft_ > 0) spanFrames = std::min(spanFrames, modeCrossfadeFramesLeft_);
+        float* out = outputBuffer + static_cast<size_t>(i) * outputStreamChannels;
+
+        if (playbackIncrement == PLAYHEAD_ONE && (localPlayhead & (PLAYHEAD_ONE - 1)) == 0) {
+            // Unity rate on an integer frame: the kernel reduces to the centre tap, so copy with gain.
+            // The span stays inside [0, totalFrames), so the loop seam is never needed here.
+            const int32_t startFrame = static_cast<int32_t>(localPlayhead >> PLAYHEAD_FRACTION_BITS);
+            switch (body.format) {
+                case SampleFormat::PlanarFloat:
+                    mixUnitySpan<SampleFormat::PlanarFloat>(body, startFrame, spanFrames, out, outputStreamChannels, effectiveVolume, 0.0f);
+                    break;
+                case SampleFormat::InterleavedFloat:
+                    mixUnitySpan<SampleFormat::InterleavedFloat>(body, startFrame, spanFrames, out, outputStreamChannels, effectiveVolume, 0.0f);
+                    break;
+                case SampleFormat::InterleavedInt16:
+                    mixUnitySpan<SampleFormat::InterleavedInt16>(body, startFrame, spanFrames, out, outputStreamChannels, effectiveVolume, 0.0f);
+                    break;
+                case SampleFormat::PlanarInt16:
+                    mixUnitySpan<SampleFormat::PlanarInt16>(body, startFrame, spanFrames, out, outputStreamChannels, effectiveVolume, 0.0f);
+                    break;
+            }
+            localPlayhead += static_cast<int64_t>(spanFrames) << PLAYHEAD_FRACTION_BITS;
+        } else {
+            // Above unity rate, read from the mipmap level that brings the rate back to <= 1 when it
+            // has been built, and cover whatever rate remains with an anti-aliasing bank.
+            const PlanarBuffer* source = &s->audioData;
+            const PlanarBuffer* seam = &s->loopSeam;
+            int levelShift = 0;
+            const float absRate = std::fabs(playbackRateToUse) * static_cast<float>(sourceRateRatio);
+            if (absRate > 1.0f) {
+                const int levelsReady = s->mipmapLevelsReady.load(std::memory_order_acquire);
+                while (levelShift < levelsReady && absRate > static_cast<float>(1 << levelShift)) {
+                    ++levelShift;
+                }
+                if (levelShift > 0) {
+                    const AudioSample::MipLevel& level = s->mipLevels[levelShift - 1];
+                    source = &level.data;
+                    seam = &level.loopSeam;
+                }
+            }
+
+            // While looping, a kernel within GUARD_FRAMES of either end reads across the loop point;
+            // those spans come from the seam, where the frames on both sides of the wrap sit together.
+            // A WAV played in place does the same at level 0 without looping, reading its ends'
+            // planar copies, whose guards are silent.
+            SourceView view = levelShift > 0 ? SourceView{source->framePtrs.data(), 0} : body;
+            const bool readsInPlace = direct && levelShift == 0;
+            if (looping || readsInPlace) {
+                const int shift = levelShift + PLAYHEAD_FRACTION_BITS;
+                const int32_t levelFrames = levelShift > 0 ? source->frames : s->totalFrames;
+                const int32_t tailStart = std::max(GUARD_FRAMES, levelFrames - GUARD_FRAMES);
+                const int32_t baseFrame = static_cast<int32_t>(localPlayhead >> shift);
+                if (baseFrame < GUARD_FRAMES) {
+                    view = looping ? SourceView{seam->framePtrs.data(), -2 * GUARD_FRAMES} : SourceView{direct->head.framePtrs.data(), 0};
+                    spanFrames = framesWithin(localPlayhead, playbackIncrement, 0, int64_t(GUARD_FRAMES) << shift, spanFrames);
+                } else if (baseFrame >= tailStart) {
+                    view = {looping ? seam->framePtrs.data() : direct->tail.framePtrs.data(), levelFrames - 2 * GUARD_FRAMES};
+                    spanFrames = framesWithin(localPlayhead, playbackIncrement, int64_t(tailStart) << shift, endPlayhead, spanFrames);
+                } else {
+                    spanFrames = framesWithin(localPlayhead, playbackIncrement, int64_t(GUARD_FRAMES) << shift,
+                                              int64_t(tailStart) << shift, spanFrames);
+                }
+            }
+
+            const SincKernelTable* aaBank = antiAliasBankForRate(absRate / static_cast<float>(1 << levelShift));
+            if (outputStreamChannels != outputChannelCount) {
+                // Stream layout differs from the one bound for this voice; take the generic mapping
+                localPlayhead = (this->*genericRenderSpan(view.format))(aaBank ? *aaBank : *kernel_, view, levelShift, localPlayhead,
+                                                                        playbackIncrement, spanFrames, out, outputStreamChannels, effectiveVolume, 0.0f);
+            } else if (aaBank) {
+                localPlayhead = (this->*antiAliasRenderSpan_[static_cast<int>(view.format)])(*aaBank, view, levelShift, localPlayhead, playbackIncrement,
+                                                                                            spanFrames, out, outputStreamChannels, effectiveVolume, 0.0f);
+            } else if (modeCrossfadeFramesLeft_ > 0) {
+                // Both interpolators start from the same playhead and advance identically; only their gains ramp
+                const float gainStep = effectiveVolume / static_cast<float>(INTERPOLATION_CROSSFADE_FRAMES);
+                const float fromGain = gainStep * static_cast<float>(modeCrossfadeFramesLeft_);
+                (this->*rendererForMode(fadingFromMode_, view.format))(*kernel_, view, levelShift, localPlayhead, playbackIncrement,
+                                                          spanFrames, out, outputStreamChannels, fromGain, -gainStep);
+                localPlayhead = (this->*rendererForMode(interpolationMode_, view.format))(*kernel_, view, levelShift, localPlayhead, playbackIncrement,
+                                                                             spanFrames, out, outputStreamChannels, effectiveVolume - fromGain, gainStep);
+                modeCrossfadeFramesLeft_ -= spanFrames;
+            } else {
+                localPlayhead = (this->*rendererForMode(interpolationMode_, view.format))(*kernel_, view, levelShift, localPlayhead, playbackIncrement,
+                                                                             spanFrames, out, outputStreamChannels, effectiveVolume, 0.0f);
             }
-            outputBuffer[i * outputStreamChannels + ch_out] += interpolatedSample * effectiveVolume;
         }
-        localPreciseCurrentFrame += playbackRateToUse;
+        i += spanFrames;
     }
-    preciseCurrentFrame.store(localPreciseCurrentFrame);
+    playhead = localPlayhead;
 }
 
 
@@ -490,9 +2579,31 @@ bool AudioEngine::init(AAssetManager* mgr) {
               streamSampleRate_, audioStream_->getChannelCount(),
               oboe::convertToText(audioStream_->getFormat()),
               oboe::convertToText(audioStream_->getState()));
-        platterAudioSample_ = std::make_unique<AudioSample>();
-        musicAudioSample_ = std::make_unique<AudioSample>();
-        ALOGI("AudioEngine init: Platter and Music AudioSample unique_ptrs created.");
+        for (Voice& voice : voices_) {
+            voice.audioEnginePtr = this;
+            voice.outputChannelCount = audioStream_->getChannelCount();
+        }
+        platterVoice_ = acquireVoice(VoicePriority::Platter);
+        platterVoice_->reserved = true;
+        platterVoice_->interpolationQuality = PLATTER_INTERPOLATION_QUALITY;
+        platterVoice_->kernelShape = PLATTER_KERNEL_SHAPE;
+        musicVoice_ = acquireVoice(VoicePriority::Music);
+        musicVoice_->reserved = true;
+        musicVoice_->interpolationQuality = MUSIC_INTERPOLATION_QUALITY;
+        if (STREAM_MUSIC_TRACKS) musicVoice_->streamWindow_.allocate(2, STREAM_WINDOW_FRAMES);
+        ALOGI("AudioEngine init: %d voices preallocated, platter and music voices reserved.", MAX_VOICES);
+        ALOGI("Sinc tables compiled in: %d steps, %d tiers (%d to %d taps), %d anti-aliasing banks up to %.1fx, %zu bytes of coefficients",
+              SUBDIVISION_STEPS, NUM_QUALITY_TIERS, QUALITY_TIER_TAPS[0], QUALITY_TIER_TAPS[NUM_QUALITY_TIERS - 1],
+              NUM_ANTI_ALIAS_BANKS, MAX_SCRATCH_RATE, KERNEL_TABLE_BYTES);
+        const int platterTier = static_cast<int>(PLATTER_INTERPOLATION_QUALITY);
+        Voice::logKernelLatency("linear-phase", SINC_TABLES[platterTier]);
+        Voice::logKernelLatency("low-delay", LOW_DELAY_TABLES[platterTier]);
+        {
+            // Room for a start per voice and then some, so pushCommands does not allocate
+            std::lock_guard<std::mutex> lock(commandProducerMutex_);
+            retiredSamples_.reserve(4 * MAX_VOICES);
+        }
+        loaderThread_ = std::thread(&AudioEngine::loaderThreadMain, this);
         return true;
     } else {
         ALOGE("Failed to open stream OR stream object is invalid. Oboe Result: %s. audioStream_.get(): %p",
@@ -509,14 +2620,28 @@ bool AudioEngine::init(AAssetManager* mgr) {
 
 void AudioEngine::release() {
     ALOGI("AudioEngine release.");
+    stopLoader(); // Nothing may install a sample past this point
     if (audioStream_) {
         stopStream();
         audioStream_->close();
         audioStream_.reset();
     }
-    platterAudioSample_.reset();
-    musicAudioSample_.reset();
-    ALOGI("AudioEngine release: Platter and Music AudioSample unique_ptrs reset.");
+    // The stream is closed, so no callback can be reading the samples any more, and this thread
+    // can stand in as the queue's consumer to discard what was never applied
+    commandQueue_.drain([](const EngineCommand&) {});
+    for (int i = 0; i < MAX_VOICES; ++i) {
+        voices_[i].active = false;
+        voices_[i].isPlaying = false;
+        voices_[i].sample = nullptr;
+        voiceSamples_[i].reset();
+        replacedVoiceSamples_[i].reset();
+    }
+    {
+        std::lock_guard<std::mutex> lock(commandProducerMutex_);
+        retiredSamples_.clear();
+    }
+    sampleCache_.clear();
+    ALOGI("AudioEngine release: Voice samples released.");
     appAssetManager_ = nullptr;
 }
 
@@ -584,10 +2709,289 @@ oboe::Result AudioEngine::stopStream() {
     return result;
 }
 
+std::shared_ptr<AudioSample> AudioEngine::loadSample(const std::string& basePath, bool buildMipmapPyramid, bool convertToOutputRate,
+                                                     bool storeAsInt16) {
+    auto sample = std::make_shared<AudioSample>();
+    sample->outputSampleRate = streamSampleRate_;
+    sample->load(appAssetManager_, basePath, buildMipmapPyramid, convertToOutputRate, storeAsInt16);
+    return sample;
+}
+
+// Streamed samples bypass sampleCache_: each holds an open decoder and a read position, so none
+// can be shared or kept for later
+std::shared_ptr<AudioSample> AudioEngine::openStreamedSample(const std::string& basePath) {
+    auto sample = std::make_shared<AudioSample>();
+    sample->outputSampleRate = streamSampleRate_;
+    const std::string resolvedPath = AudioSample::resolveAssetPath(appAssetManager_, basePath);
+    sample->openStream(appAssetManager_, resolvedPath.empty() ? basePath : resolvedPath, 0);
+    return sample;
+}
+
+// Resolves basePath first, so a sample already decoded under any spelling of it is found
+std::shared_ptr<AudioSample> AudioEngine::loadSampleCached(const std::string& basePath, bool buildMipmapPyramid, bool convertToOutputRate,
+                                                           bool storeAsInt16) {
+    const std::string resolvedPath = AudioSample::resolveAssetPath(appAssetManager_, basePath);
+    if (resolvedPath.empty()) return loadSample(basePath, buildMipmapPyramid, convertToOutputRate, storeAsInt16); // Fails, and logs why
+    const std::string key = SampleCache::key(resolvedPath, buildMipmapPyramid, convertToOutputRate, storeAsInt16);
+    if (std::shared_ptr<AudioSample> cached = sampleCache_.find(key)) return cached;
+    std::shared_ptr<AudioSample> sample = loadSample(resolvedPath, buildMipmapPyramid, convertToOutputRate, storeAsInt16);
+    if (sample->totalFrames > 0) sampleCache_.insert(key, sample);
+    const SampleCache::Stats stats = sampleCache_.stats();
+    ALOGI("SampleCache: %zu entries, %zu / %zu KB, %llu hits, %llu misses, %llu evictions", stats.entries, stats.bytes / 1024,
+          stats.byteBudget / 1024, static_cast<unsigned long long>(stats.hits), static_cast<unsigned long long>(stats.misses),
+          static_cast<unsigned long long>(stats.evictions));
+    return sample;
+}
+
+std::shared_ptr<AudioSample> SampleCache::find(const std::string& key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto found = index_.find(key);
+    if (found == index_.end()) {
+        ++stats_.misses;
+        return nullptr;
+    }
+    ++stats_.hits;
+    entries_.splice(entries_.begin(), entries_, found->second);
+    ALOGV("SampleCache: hit for '%s'", key.c_str());
+    return found->second->sample;
+}
+
+void SampleCache::insert(const std::string& key, std::shared_ptr<AudioSample> sample) {
+    std::list<Entry> evicted;
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto found = index_.find(key);
+    if (found != index_.end()) {
+        evicted.splice(evicted.end(), entries_, found->second);
+        index_.erase(found);
+    }
+    entries_.push_front({key, std::move(sample), 0});
+    index_[key] = entries_.begin();
+    evictOverBudget(&entries_.front(), evicted);
+}
+
+void SampleCache::setByteBudget(size_t byteBudget) {
+    std::list<Entry> evicted;
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_.byteBudget = byteBudget;
+    evictOverBudget(nullptr, evicted);
+}
+
+bool SampleCache::contains(const std::string& key) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return index_.count(key) != 0;
+}
+
+size_t SampleCache::freeBytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_.bytes < stats_.byteBudget ? stats_.byteBudget - stats_.bytes : 0;
+}
+
+bool SampleCache::insertIfRoom(const std::string& key, std::shared_ptr<AudioSample> sample) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (index_.count(key)) return true;
+    const size_t bytes = sample->residentBytes();
+    if (stats_.bytes + bytes > stats_.byteBudget) return false;
+    // Least recently used of all: a prefetch guess should not outlive what was actually played
+    entries_.push_back({key, std::move(sample), bytes});
+    index_[key] = std::prev(entries_.end());
+    stats_.bytes += bytes;
+    stats_.entries = entries_.size();
+    return true;
+}
+
+SampleCache::Stats SampleCache::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+void SampleCache::clear() {
+    std::list<Entry> evicted;
+    std::lock_guard<std::mutex> lock(mutex_);
+    evicted.swap(entries_);
+    index_.clear();
+    stats_.bytes = 0;
+    stats_.entries = 0;
+}
+
+// Called with mutex_ held. Samples grow after they are cached as their mipmap levels are built,
+// so the sizes are re-measured here rather than trusted from insert time.
+void SampleCache::evictOverBudget(const Entry* keep, std::list<Entry>& evicted) {
+    stats_.bytes = 0;
+    for (Entry& entry : entries_) {
+        entry.bytes = entry.sample->residentBytes();
+        stats_.bytes += entry.bytes;
+    }
+    while (stats_.bytes > stats_.byteBudget && !entries_.empty() && &entries_.back() != keep) {
+        Entry& victim = entries_.back();
+        ALOGI("SampleCache: evicting '%s' (%zu KB)", victim.key.c_str(), victim.bytes / 1024);
+        stats_.bytes -= victim.bytes;
+        ++stats_.evictions;
+        index_.erase(victim.key);
+        evicted.splice(evicted.begin(), entries_, std::prev(entries_.end()));
+    }
+    stats_.entries = entries_.size();
+}
+
+bool AudioEngine::pushCommands(std::initializer_list<EngineCommand> commands) {
+    bool pushed;
+    bool anyRetired;
+    {
+        std::lock_guard<std::mutex> lock(commandProducerMutex_);
+        pushed = commandQueue_.tryPush(commands.begin(), commands.size());
+        if (pushed) commandsPushed_ += commands.size();
+        // The samples this batch's starts replace can go once the whole batch has been applied. If
+        // it was dropped, their voices may never let go of them, so they stay until release().
+        for (const EngineCommand& command : commands) {
+            if (command.type != EngineCommand::Type::StartVoice) continue;
+            std::shared_ptr<AudioSample>& replaced = replacedVoiceSamples_[command.voice];
+            if (replaced) retiredSamples_.push_back({std::move(replaced), pushed ? commandsPushed_ : UINT64_MAX});
+        }
+        anyRetired = !retiredSamples_.empty();
+    }
+    if (!pushed) {
+        ALOGE("pushCommands: command queue full (%zu slots), dropping %zu command(s). Is the stream running?",
+              COMMAND_QUEUE_CAPACITY, commands.size());
+    }
+    if (anyRetired) {
+        {
+            std::lock_guard<std::mutex> lock(loaderMutex_);
+            reclaimPending_ = true;
+        }
+        loaderCondition_.notify_one();
+    }
+    return pushed;
+}
+
+// Loader thread. Frees, outside the lock, every retired sample the callback has moved past.
+void AudioEngine::reclaimRetiredSamples() {
+    std::vector<std::shared_ptr<AudioSample>> reclaimable;
+    {
+        std::lock_guard<std::mutex> lock(commandProducerMutex_);
+        const uint64_t applied = commandsApplied_.load(std::memory_order_acquire);
+        for (size_t i = 0; i < retiredSamples_.size();) {
+            RetiredSample& retired = retiredSamples_[i];
+            if (retired.reclaimAfter <= applied) {
+                reclaimable.push_back(std::move(retired.sample));
+                retired = std::move(retiredSamples_.back());
+                retiredSamples_.pop_back();
+            } else {
+                ++i;
+            }
+        }
+    }
+    if (!reclaimable.empty()) ALOGV("reclaimRetiredSamples: freeing %zu sample(s)", reclaimable.size());
+}
+
+// Runs on the audio thread, between blocks
+void AudioEngine::applyCommand(const EngineCommand& command) {
+    switch (command.type) {
+        case EngineCommand::Type::StartVoice:
+            voices_[command.voice].start(command);
+            break;
+        case EngineCommand::Type::SetVoicePlaying:
+            voices_[command.voice].isPlaying = command.playing;
+            break;
+        case EngineCommand::Type::SeekVoice:
+            voices_[command.voice].playhead = command.playhead;
+            break;
+        case EngineCommand::Type::PlatterControl:
+            mix_.fingerDownOnPlatter = command.fingerDown;
+            mix_.platterTargetPlaybackRate = command.rate;
+            if (platterVoice_) {
+                platterVoice_->useEngineRateForPlayback_ = command.useEngineRate;
+                platterVoice_->isPlaying = command.playing;
+            }
+            break;
+        case EngineCommand::Type::SetPlatterFaderVolume:
+            mix_.platterFaderVolume = command.value;
+            break;
+        case EngineCommand::Type::SetMusicMasterVolume:
+            mix_.generalMusicVolume = command.value;
+            break;
+        case EngineCommand::Type::SetPowerSaveMode:
+            mix_.powerSaveMode = command.enabled;
+            break;
+    }
+}
+
+EngineCommand AudioEngine::platterControlCommand() const {
+    EngineCommand command;
+    command.type = EngineCommand::Type::PlatterControl;
+    command.fingerDown = platterControl_.fingerDown;
+    command.useEngineRate = platterControl_.useEngineRate;
+    command.playing = platterControl_.playing;
+    command.rate = platterControl_.rate;
+    return command;
+}
+
+EngineCommand AudioEngine::voicePlayingCommand(Voice* voice, bool playing) {
+    voice->controlPlaying = playing;
+    EngineCommand command;
+    command.type = EngineCommand::Type::SetVoicePlaying;
+    command.voice = static_cast<int16_t>(voiceIndex(voice));
+    command.playing = playing;
+    return command;
+}
+
+// Picks the voice for a new sound: a free one if there is any, else the oldest voice of the
+// lowest priority not above 'priority'. Reserved voices are never taken. Runs on the control
+// thread and touches only preallocated state.
+Voice* AudioEngine::acquireVoice(VoicePriority priority) {
+    // Lower is a better victim: lower priority, then older
+    auto stealsBefore = [](const Voice& a, const Voice& b) {
+        if (a.priority != b.priority) return a.priority < b.priority;
+        return a.startSequence < b.startSequence;
+    };
+    Voice* chosen = nullptr;
+    for (Voice& voice : voices_) {
+        if (voice.reserved) continue;
+        if (voice.finished()) { chosen = &voice; break; }
+        if (voice.priority > priority) continue;
+        if (!chosen || stealsBefore(voice, *chosen)) chosen = &voice;
+    }
+    if (!chosen) {
+        ALOGW("acquireVoice: all %d voices are held by higher-priority sounds", MAX_VOICES);
+        return nullptr;
+    }
+    if (!chosen->finished()) {
+        ALOGW("acquireVoice: pool full, stealing voice %d (priority %d)", voiceIndex(chosen), static_cast<int>(chosen->priority));
+    }
+    chosen->priority = priority;
+    chosen->startSequence = ++voiceStartSequence_;
+    ++chosen->generation; // Claimed from here on, even before its StartVoice is applied
+    return chosen;
+}
+
+// Makes 'voice' the owner of 'sample' and returns the StartVoice command for it, set to play once
+// from the top at unity gain and rate; callers adjust it and queue it. The previous sample is
+// parked for deferred reclamation rather than freed here, since the audio thread may still be
+// reading it.
+EngineCommand AudioEngine::prepareStart(Voice* voice, std::shared_ptr<AudioSample> sample) {
+    const int index = voiceIndex(voice);
+    ++voice->generation;
+    voice->controlPlaying = true;
+    EngineCommand command;
+    command.type = EngineCommand::Type::StartVoice;
+    command.voice = static_cast<int16_t>(index);
+    command.generation = voice->generation;
+    command.sample = sample.get();
+    command.value = 1.0f;
+    command.playing = true;
+    if (replacedVoiceSamples_[index]) {
+        // An earlier start on this voice was prepared but never queued, so the callback never saw
+        // its sample and still plays the one already parked here
+        voiceSamples_[index].reset();
+    } else {
+        replacedVoiceSamples_[index] = std::move(voiceSamples_[index]);
+    }
+    voiceSamples_[index] = std::move(sample);
+    return command;
+}
+
 void AudioEngine::playIntroAndLoopOnPlatterInternal(const std::string& initialBasePath) {
     ALOGI("AudioEngine: playIntroAndLoopOnPlatterInternal with base path: %s", initialBasePath.c_str());
     if (!appAssetManager_) { ALOGE("playIntro: appAssetManager_ is null!"); return; }
-    if (!platterAudioSample_) { ALOGE("playIntro: platterAudioSample_ is null!"); return; }
+    if (!platterVoice_) { ALOGE("playIntro: platterVoice_ is null!"); return; }
     int initialIndex = 0;
     if (!platterSamplePaths_.empty()) {
         auto it = std::find(platterSamplePaths_.begin(), platterSamplePaths_.end(), initialBasePath);
@@ -606,26 +3010,14 @@ void AudioEngine::playIntroAndLoopOnPlatterInternal(const std::string& initialBa
         platterSamplePaths_.push_back(initialBasePath);
     }
     currentPlatterSampleIndex_.store(initialIndex);
-    std::string basePathToLoad = platterSamplePaths_[currentPlatterSampleIndex_.load()];
-    platterAudioSample_->load(appAssetManager_, basePathToLoad, this);
-    if (platterAudioSample_->totalFrames > 0) {
-        platterAudioSample_->playOnceThenLoopSilently = true;
-        platterAudioSample_->playedOnce = false;
-        platterAudioSample_->loop.store(false);
-        platterAudioSample_->preciseCurrentFrame.store(0.0f);
-        platterAudioSample_->isPlaying.store(true);
-        platterAudioSample_->useEngineRateForPlayback_.store(false);
-        platterTargetPlaybackRate_.store(1.0f);
-        setPlatterFaderVolumeInternal(0.0f);
-        ALOGI("Intro sample from base '%s' loaded as '%s'. Will play once then loop.", basePathToLoad.c_str(), platterAudioSample_->filePath.c_str());
-    } else ALOGE("Failed to load intro sample from base path: %s", basePathToLoad.c_str());
+    requestLoad(LoadAction::PlatterIntro, platterSamplePaths_[currentPlatterSampleIndex_.load()]);
 }
 
 void AudioEngine::nextPlatterSampleInternal() {
     ALOGI("AudioEngine: nextPlatterSampleInternal");
-    if (!appAssetManager_ || !platterAudioSample_ || platterSamplePaths_.empty()) {
-        ALOGE("nextPlatterSample: Readiness check failed (AssetManager: %d, SamplePtr: %d, PathsEmpty: %d)",
-              (appAssetManager_ != nullptr), (platterAudioSample_ != nullptr), platterSamplePaths_.empty());
+    if (!appAssetManager_ || !platterVoice_ || platterSamplePaths_.empty()) {
+        ALOGE("nextPlatterSample: Readiness check failed (AssetManager: %d, VoicePtr: %d, PathsEmpty: %d)",
+              (appAssetManager_ != nullptr), (platterVoice_ != nullptr), platterSamplePaths_.empty());
         return;
     }
     int currentIndex = currentPlatterSampleIndex_.load();
@@ -633,25 +3025,13 @@ void AudioEngine::nextPlatterSampleInternal() {
     currentPlatterSampleIndex_.store(currentIndex);
     std::string nextBasePath = platterSamplePaths_[currentIndex];
     ALOGI("Loading next platter sample from base path: %s (index %d)", nextBasePath.c_str(), currentIndex);
-    platterAudioSample_->load(appAssetManager_, nextBasePath, this);
-    if (platterAudioSample_->totalFrames > 0) {
-        platterAudioSample_->loop.store(true);
-        platterAudioSample_->playOnceThenLoopSilently = false;
-        platterAudioSample_->preciseCurrentFrame.store(0.0f);
-        platterAudioSample_->isPlaying.store(true);
-        platterAudioSample_->useEngineRateForPlayback_.store(false);
-        platterTargetPlaybackRate_.store(1.0f);
-        ALOGI("Next platter sample loaded as '%s'", platterAudioSample_->filePath.c_str());
-    } else {
-        ALOGE("Failed to load next platter sample from base: %s", nextBasePath.c_str());
-        if(platterAudioSample_) platterAudioSample_->isPlaying.store(false);
-    }
+    requestLoad(LoadAction::PlatterLoop, nextBasePath);
 }
 
 void AudioEngine::playMusicTrackInternal() {
     ALOGI("AudioEngine: playMusicTrackInternal called.");
     if (!appAssetManager_) { ALOGE("playMusicTrackInternal: appAssetManager_ is NULL."); return; }
-    if (!musicAudioSample_) { ALOGE("playMusicTrackInternal: musicAudioSample_ unique_ptr is NULL."); return; }
+    if (!musicVoice_) { ALOGE("playMusicTrackInternal: musicVoice_ is NULL."); return; }
     if (musicTrackPaths_.empty()) { ALOGE("playMusicTrackInternal: musicTrackPaths_ vector is EMPTY. Count: %zu", musicTrackPaths_.size()); return; }
     if (currentMusicTrackIndex_.load() < 0 || currentMusicTrackIndex_.load() >= musicTrackPaths_.size()) {
         ALOGE("playMusicTrackInternal: currentMusicTrackIndex_ (%d) out of bounds. Resetting.", currentMusicTrackIndex_.load());
@@ -660,32 +3040,37 @@ void AudioEngine::playMusicTrackInternal() {
     }
     std::string basePathToPlay = musicTrackPaths_[currentMusicTrackIndex_.load()];
     ALOGI("Attempting to play music track from base: %s (index %d)", basePathToPlay.c_str(), currentMusicTrackIndex_.load());
-    if (musicAudioSample_->isPlaying.load() &&
-        (musicAudioSample_->filePath == basePathToPlay + ".mp3" || musicAudioSample_->filePath == basePathToPlay + ".wav" || musicAudioSample_->filePath == basePathToPlay) ) {
-        ALOGI("Music track from base '%s' (resolved to '%s') is already playing. Restarting.", basePathToPlay.c_str(), musicAudioSample_->filePath.c_str());
-        musicAudioSample_->preciseCurrentFrame.store(0.0f);
-        return;
-    }
-    musicAudioSample_->load(appAssetManager_, basePathToPlay, this);
-    if (musicAudioSample_->totalFrames > 0) {
-        musicAudioSample_->loop.store(false);
-        musicAudioSample_->playOnceThenLoopSilently = false;
-        musicAudioSample_->preciseCurrentFrame.store(0.0f);
-        musicAudioSample_->isPlaying.store(true);
-        ALOGI("Playing music track loaded as '%s'", musicAudioSample_->filePath.c_str());
-    } else {
-        ALOGE("Failed to load music track for playback from base: %s", basePathToPlay.c_str());
-        if(musicAudioSample_) musicAudioSample_->isPlaying.store(false);
+    {
+        std::lock_guard<std::mutex> lock(controlMutex_);
+        const std::shared_ptr<AudioSample>& currentTrack = voiceSamples_[voiceIndex(musicVoice_)];
+        if (musicVoice_->isPlayingForControl() && currentTrack &&
+            (currentTrack->filePath == basePathToPlay + ".mp3" || currentTrack->filePath == basePathToPlay + ".wav" || currentTrack->filePath == basePathToPlay) ) {
+            ALOGI("Music track from base '%s' (resolved to '%s') is already playing. Restarting.", basePathToPlay.c_str(), currentTrack->filePath.c_str());
+            if (currentTrack->stream) {
+                // The voice only holds a window of a streamed track; reopen it at the start instead
+                requestLoad(LoadAction::MusicPlay, basePathToPlay);
+                return;
+            }
+            EngineCommand seek;
+            seek.type = EngineCommand::Type::SeekVoice;
+            seek.voice = static_cast<int16_t>(voiceIndex(musicVoice_));
+            seek.playhead = 0;
+            pushCommands({seek});
+            return;
+        }
     }
+    requestLoad(LoadAction::MusicPlay, basePathToPlay);
 }
 
 void AudioEngine::stopMusicTrackInternal() {
     ALOGI("AudioEngine: stopMusicTrackInternal");
-    if (musicAudioSample_) {
-        musicAudioSample_->isPlaying.store(false);
-        ALOGI("Stopped music track: %s", musicAudioSample_->filePath.c_str());
+    if (musicVoice_) {
+        std::lock_guard<std::mutex> lock(controlMutex_);
+        pushCommands({voicePlayingCommand(musicVoice_, false)});
+        const std::shared_ptr<AudioSample>& currentTrack = voiceSamples_[voiceIndex(musicVoice_)];
+        ALOGI("Stopped music track: %s", currentTrack ? currentTrack->filePath.c_str() : "(none)");
     } else {
-        ALOGW("stopMusicTrackInternal: musicAudioSample_ is null.");
+        ALOGW("stopMusicTrackInternal: musicVoice_ is null.");
     }
 }
 
@@ -702,64 +3087,255 @@ void AudioEngine::nextMusicTrackAndPlayInternal() {
 void AudioEngine::nextMusicTrackAndKeepStateInternal() {
     ALOGI("AudioEngine: nextMusicTrackAndKeepStateInternal");
     if (musicTrackPaths_.empty()) { ALOGW("No music tracks in list. Count: %zu", musicTrackPaths_.size()); return; }
-    bool wasPlaying = musicAudioSample_ && musicAudioSample_->isPlaying.load();
+    if (!musicVoice_) { ALOGE("nextMusicTrackAndKeepStateInternal: musicVoice_ is null!"); return; }
     int currentIndex = currentMusicTrackIndex_.load();
     currentIndex = (currentIndex + 1) % musicTrackPaths_.size();
     currentMusicTrackIndex_.store(currentIndex);
     std::string nextTrackBasePath = musicTrackPaths_[currentIndex];
-    ALOGI("Advanced to next music track (keep state), base: %s (index %d). Was playing: %d", nextTrackBasePath.c_str(), currentIndex, wasPlaying);
-    if (!musicAudioSample_) {
-        ALOGE("nextMusicTrackAndKeepStateInternal: musicAudioSample_ is null!");
-        musicAudioSample_ = std::make_unique<AudioSample>();
-    }
-    musicAudioSample_->load(appAssetManager_, nextTrackBasePath, this);
-    if (musicAudioSample_->totalFrames > 0) {
-        if (wasPlaying) {
-            musicAudioSample_->preciseCurrentFrame.store(0.0f);
-            musicAudioSample_->isPlaying.store(true);
-            ALOGI("Resuming playback with new track loaded as '%s'", musicAudioSample_->filePath.c_str());
-        } else {
-            musicAudioSample_->isPlaying.store(false);
-            ALOGI("New track loaded as '%s', was not playing.", musicAudioSample_->filePath.c_str());
+    ALOGI("Advanced to next music track (keep state), base: %s (index %d)", nextTrackBasePath.c_str(), currentIndex);
+    requestLoad(LoadAction::MusicKeepState, nextTrackBasePath);
+}
+
+// Queues a load for the loader thread, dropping any request for the same target still waiting
+// there, and returns without decoding anything
+void AudioEngine::requestLoad(LoadAction action, const std::string& basePath) {
+    const LoadTarget target = (action == LoadAction::PlatterIntro || action == LoadAction::PlatterLoop)
+                              ? LoadTarget::Platter : LoadTarget::Music;
+    const int targetIndex = static_cast<int>(target);
+    {
+        std::lock_guard<std::mutex> lock(loaderMutex_);
+        if (!loaderThread_.joinable() || loaderStopping_) {
+            ALOGE("requestLoad: loader not running, dropping '%s'", basePath.c_str());
+            return;
         }
-    } else {
-        ALOGE("Failed to load track from base '%s'.", nextTrackBasePath.c_str());
-        if(musicAudioSample_) musicAudioSample_->isPlaying.store(false);
+        loadRequests_.erase(std::remove_if(loadRequests_.begin(), loadRequests_.end(),
+                                           [target](const LoadRequest& queued) { return queued.target == target; }),
+                            loadRequests_.end());
+        loadRequests_.push_back({action, target, ++loadSequence_[targetIndex], basePath});
+        loadState_[targetIndex].store(LoadState::Loading, std::memory_order_release);
+    }
+    loaderCondition_.notify_one();
+}
+
+void AudioEngine::loaderThreadMain() {
+    ALOGI("Loader thread started.");
+    std::unique_lock<std::mutex> lock(loaderMutex_);
+    for (;;) {
+        loaderCondition_.wait(lock, [this] { return loaderStopping_ || !loadRequests_.empty() || prefetchPending_ || reclaimPending_; });
+        if (loaderStopping_) break;
+        if (reclaimPending_) {
+            reclaimPending_ = false;
+            lock.unlock();
+            reclaimRetiredSamples();
+            lock.lock();
+            continue;
+        }
+        if (loadRequests_.empty()) {
+            // Idle: decode what the buttons will ask for next. Requests that come in meanwhile
+            // are served between prefetches.
+            prefetchPending_ = false;
+            lock.unlock();
+            prefetchNeighbours();
+            lock.lock();
+            continue;
+        }
+        LoadRequest request = std::move(loadRequests_.front());
+        loadRequests_.pop_front();
+        lock.unlock();
+        auto startTime = std::chrono::steady_clock::now();
+        std::shared_ptr<AudioSample> sample = (request.target == LoadTarget::Music && STREAM_MUSIC_TRACKS)
+            ? openStreamedSample(request.basePath)
+            : loadSampleCached(request.basePath, buildsMipmaps(request.target), convertsRate(request.target), storesInt16(request.target));
+        ALOGI("Loader: '%s' ready in %lld ms", request.basePath.c_str(),
+              static_cast<long long>(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime).count()));
+        installLoadedSample(request, std::move(sample));
+        lock.lock();
+        prefetchPending_ = true; // The current item moved, and with it its neighbours
+    }
+    ALOGI("Loader thread stopped.");
+}
+
+// Loader thread. Decodes the entries around the current platter sample and music track into the
+// cache: the next ones up to prefetchDepth_ ahead first, then the previous ones. Stops early when
+// a real request is waiting or the cache is out of room.
+void AudioEngine::prefetchNeighbours() {
+    const int depth = prefetchDepth_.load();
+    const bool previous = prefetchPrevious_.load();
+    if (depth <= 0 && !previous) return;
+    std::vector<std::pair<LoadTarget, std::string>> candidates;
+    auto addNeighbour = [&candidates](LoadTarget target, const std::vector<std::string>& paths, int current, int offset) {
+        const int count = static_cast<int>(paths.size());
+        if (count < 2 || std::abs(offset) >= count) return; // Would wrap round to the current entry
+        candidates.emplace_back(target, paths[((current + offset) % count + count) % count]);
+    };
+    for (int offset = 1; offset <= depth; ++offset) {
+        addNeighbour(LoadTarget::Platter, platterSamplePaths_, currentPlatterSampleIndex_.load(), offset);
+        if (!STREAM_MUSIC_TRACKS) addNeighbour(LoadTarget::Music, musicTrackPaths_, currentMusicTrackIndex_.load(), offset);
+    }
+    if (previous) {
+        addNeighbour(LoadTarget::Platter, platterSamplePaths_, currentPlatterSampleIndex_.load(), -1);
+        if (!STREAM_MUSIC_TRACKS) addNeighbour(LoadTarget::Music, musicTrackPaths_, currentMusicTrackIndex_.load(), -1);
+    }
+
+    for (const auto& [target, basePath] : candidates) {
+        {
+            std::lock_guard<std::mutex> lock(loaderMutex_);
+            if (loaderStopping_ || !loadRequests_.empty()) {
+                prefetchPending_ = true; // Finish the round once the request is served
+                return;
+            }
+        }
+        const std::string resolvedPath = AudioSample::resolveAssetPath(appAssetManager_, basePath);
+        if (resolvedPath.empty()) continue;
+        const std::string key = SampleCache::key(resolvedPath, buildsMipmaps(target), convertsRate(target), storesInt16(target));
+        if (sampleCache_.contains(key)) continue;
+        if (sampleCache_.freeBytes() == 0) {
+            ALOGI("Prefetch: sample cache is full, stopping");
+            return;
+        }
+        auto startTime = std::chrono::steady_clock::now();
+        std::shared_ptr<AudioSample> sample = loadSample(resolvedPath, buildsMipmaps(target), convertsRate(target), storesInt16(target));
+        if (sample->totalFrames == 0) continue;
+        const size_t bytes = sample->residentBytes();
+        if (!sampleCache_.insertIfRoom(key, std::move(sample))) {
+            ALOGI("Prefetch: '%s' (%zu KB) does not fit in the sample cache, dropped", resolvedPath.c_str(), bytes / 1024);
+            return;
+        }
+        ALOGI("Prefetch: '%s' decoded in %lld ms", resolvedPath.c_str(),
+              static_cast<long long>(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime).count()));
+    }
+}
+
+void AudioEngine::setPrefetchDepthInternal(int depth, bool includePrevious) {
+    ALOGI("AudioEngine: Prefetch depth %d, previous %s", depth, includePrevious ? "on" : "off");
+    prefetchDepth_.store(std::max(depth, 0));
+    prefetchPrevious_.store(includePrevious);
+    {
+        std::lock_guard<std::mutex> lock(loaderMutex_);
+        prefetchPending_ = true;
+    }
+    loaderCondition_.notify_one();
+}
+
+void AudioEngine::stopLoader() {
+    {
+        std::lock_guard<std::mutex> lock(loaderMutex_);
+        if (!loaderThread_.joinable()) return;
+        loaderStopping_ = true;
+        loadRequests_.clear();
+    }
+    loaderCondition_.notify_all();
+    loaderThread_.join(); // Waits out a decode already under way
+    std::lock_guard<std::mutex> lock(loaderMutex_);
+    loaderStopping_ = false;
+}
+
+// Records the outcome of 'request' unless a newer request for its target has come in since.
+// Returns whether it was still the latest.
+bool AudioEngine::finishLoad(const LoadRequest& request, LoadState state) {
+    const int targetIndex = static_cast<int>(request.target);
+    std::lock_guard<std::mutex> lock(loaderMutex_);
+    if (request.sequence != loadSequence_[targetIndex]) return false;
+    loadState_[targetIndex].store(state, std::memory_order_release);
+    return true;
+}
+
+// Loader thread. Hands a decoded sample to its voice, or reports the failure, unless the request
+// was superseded while it decoded.
+void AudioEngine::installLoadedSample(const LoadRequest& request, std::shared_ptr<AudioSample> sample) {
+    std::lock_guard<std::mutex> lock(controlMutex_);
+    const bool loaded = sample->playable();
+    if (!finishLoad(request, loaded ? LoadState::Ready : LoadState::Failed)) {
+        ALOGI("Loader: '%s' was superseded while decoding, discarding it", request.basePath.c_str());
+        return;
+    }
+    switch (request.action) {
+        case LoadAction::PlatterIntro:
+        case LoadAction::PlatterLoop:
+            if (loaded) {
+                EngineCommand start = prepareStart(platterVoice_, sample);
+                const bool intro = request.action == LoadAction::PlatterIntro;
+                start.playOnceThenLoop = intro;
+                start.loop = !intro;
+                platterControl_.useEngineRate = false;
+                platterControl_.playing = true;
+                platterControl_.rate = 1.0f;
+                if (intro) {
+                    EngineCommand fader;
+                    fader.type = EngineCommand::Type::SetPlatterFaderVolume;
+                    fader.value = 0.0f;
+                    pushCommands({start, platterControlCommand(), fader});
+                    ALOGI("AudioEngine: Platter Fader Volume set to %f", 0.0f);
+                    ALOGI("Intro sample from base '%s' loaded as '%s'. Will play once then loop.", request.basePath.c_str(), sample->filePath.c_str());
+                } else {
+                    pushCommands({start, platterControlCommand()});
+                    ALOGI("Next platter sample loaded as '%s'", sample->filePath.c_str());
+                }
+            } else {
+                ALOGE("Failed to load platter sample from base path: %s", request.basePath.c_str());
+                platterControl_.playing = false;
+                pushCommands({platterControlCommand()});
+            }
+            break;
+        case LoadAction::MusicPlay:
+        case LoadAction::MusicKeepState:
+            if (loaded) {
+                // Keeping state means following whatever the transport is doing now, not when asked
+                const bool playing = request.action == LoadAction::MusicPlay || musicVoice_->isPlayingForControl();
+                EngineCommand start = prepareStart(musicVoice_, sample);
+                start.playing = playing;
+                musicVoice_->controlPlaying = playing;
+                pushCommands({start});
+                ALOGI("Music track loaded as '%s', %s", sample->filePath.c_str(), playing ? "playing" : "was not playing");
+            } else {
+                ALOGE("Failed to load music track from base: %s", request.basePath.c_str());
+                pushCommands({voicePlayingCommand(musicVoice_, false)});
+            }
+            break;
     }
 }
 
 void AudioEngine::setPlatterFaderVolumeInternal(float volume) {
     float clampedVolume = std::clamp(volume, 0.0f, 1.0f);
-    platterFaderVolume_.store(clampedVolume);
+    EngineCommand command;
+    command.type = EngineCommand::Type::SetPlatterFaderVolume;
+    command.value = clampedVolume;
+    pushCommands({command});
     ALOGI("AudioEngine: Platter Fader Volume set to %f", clampedVolume);
 }
 
 void AudioEngine::setMusicMasterVolumeInternal(float volume) {
     float clampedVolume = std::clamp(volume, 0.0f, 1.0f);
-    generalMusicVolume_.store(clampedVolume);
+    EngineCommand command;
+    command.type = EngineCommand::Type::SetMusicMasterVolume;
+    command.value = clampedVolume;
+    pushCommands({command});
     ALOGI("AudioEngine: Music Master Volume set to %f", clampedVolume);
 }
 
 // MODIFIED: Logic to handle coasting rates and isPlaying state
+// Works on platterControl_ and sends the result as one PlatterControl command.
 void AudioEngine::scratchPlatterActiveInternal(bool isActiveTouch, float angleDeltaOrRateFromViewModel) {
     // Log 1: Input parameters
     ALOGV("AudioEngine::scratchPlatterActiveInternal - Input: isActiveTouch:%d, angleDeltaOrRate:%.4f", isActiveTouch, angleDeltaOrRateFromViewModel);
 
-    isFingerDownOnPlatter_.store(isActiveTouch);
+    std::lock_guard<std::mutex> lock(controlMutex_);
+    platterControl_.fingerDown = isActiveTouch;
 
-    if (!platterAudioSample_ || platterAudioSample_->totalFrames == 0) {
+    if (!platterVoice_ || !voiceSamples_[voiceIndex(platterVoice_)]) {
         if(isActiveTouch) ALOGW("ScratchPlatterActive: Attempt on unloaded/invalid platter sample.");
-        if(platterAudioSample_) { 
-            platterAudioSample_->useEngineRateForPlayback_.store(false);
+        if(platterVoice_) {
+            platterControl_.useEngineRate = false;
+            pushCommands({platterControlCommand()});
             // Log 3 & 4 for early exit path, using the specified format
-            ALOGV("AudioEngine::scratchPlatterActiveInternal - PlatterSample State: useEngineRate:%d, isPlaying:%d", platterAudioSample_->useEngineRateForPlayback_.load(), platterAudioSample_->isPlaying.load());
+            ALOGV("AudioEngine::scratchPlatterActiveInternal - PlatterSample State: useEngineRate:%d, isPlaying:%d", platterControl_.useEngineRate, platterControl_.playing);
         }
         return;
     }
 
-    platterAudioSample_->useEngineRateForPlayback_.store(true);
+    platterControl_.useEngineRate = true;
     // Log 3 & 4 after setting useEngineRateForPlayback_, using the specified format
-    ALOGV("AudioEngine::scratchPlatterActiveInternal - PlatterSample State: useEngineRate:%d, isPlaying:%d", platterAudioSample_->useEngineRateForPlayback_.load(), platterAudioSample_->isPlaying.load());
+    ALOGV("AudioEngine::scratchPlatterActiveInternal - PlatterSample State: useEngineRate:%d, isPlaying:%d", platterControl_.useEngineRate, platterControl_.playing);
     
     float targetAudioRate;
     float currentSensitivity = scratchSensitivity_.load();
@@ -781,56 +3357,47 @@ void AudioEngine::scratchPlatterActiveInternal(bool isActiveTouch, float angleDe
             }
             targetAudioRate = normalizedInputRate * currentSensitivity;
 
-            targetAudioRate = std::clamp(targetAudioRate, -4.0f, 4.0f);
-            if (!platterAudioSample_->isPlaying.load()) {
-                platterAudioSample_->isPlaying.store(true);
-            }
+            targetAudioRate = std::clamp(targetAudioRate, -MAX_SCRATCH_RATE, MAX_SCRATCH_RATE);
+            platterControl_.playing = true;
         } else { // Finger is down, but not moving
             targetAudioRate = 0.0f;
-            if (platterAudioSample_->isPlaying.load()) {
-                platterAudioSample_->isPlaying.store(false);
-            }
+            platterControl_.playing = false;
         }
         // Log 3 & 4 after potential modifications in isActiveTouch=true branch, using the specified format
-        ALOGV("AudioEngine::scratchPlatterActiveInternal - PlatterSample State: useEngineRate:%d, isPlaying:%d", platterAudioSample_->useEngineRateForPlayback_.load(), platterAudioSample_->isPlaying.load());
+        ALOGV("AudioEngine::scratchPlatterActiveInternal - PlatterSample State: useEngineRate:%d, isPlaying:%d", platterControl_.useEngineRate, platterControl_.playing);
 
     } else { // Finger is NOT on platter (isActiveTouch is false)
         targetAudioRate = angleDeltaOrRateFromViewModel; // This is the desired normalized audio rate
         
-        if (std::fabs(targetAudioRate) > 0.00001f) { // If coasting rate is non-zero
-            if(!platterAudioSample_->isPlaying.load()) {
-                platterAudioSample_->isPlaying.store(true);
-            }
-        } else { // Coasting rate is effectively zero
-            if(platterAudioSample_->isPlaying.load()) {
-                platterAudioSample_->isPlaying.store(false);
-            }
-        }
+        // Plays while the coasting rate is non-zero
+        platterControl_.playing = std::fabs(targetAudioRate) > 0.00001f;
         // Log 3 & 4 after potential modifications in isActiveTouch=false branch, using the specified format
-        ALOGV("AudioEngine::scratchPlatterActiveInternal - PlatterSample State: useEngineRate:%d, isPlaying:%d", platterAudioSample_->useEngineRateForPlayback_.load(), platterAudioSample_->isPlaying.load());
+        ALOGV("AudioEngine::scratchPlatterActiveInternal - PlatterSample State: useEngineRate:%d, isPlaying:%d", platterControl_.useEngineRate, platterControl_.playing);
     }
 
     // Log 2: Calculated targetAudioRate before storing
     ALOGV("AudioEngine::scratchPlatterActiveInternal - Calculated: targetAudioRate:%.4f", targetAudioRate);
-    platterTargetPlaybackRate_.store(targetAudioRate);
+    platterControl_.rate = targetAudioRate;
+    pushCommands({platterControlCommand()});
 
     // Final state log (Log 3 & 4 again) for completeness after storing targetAudioRate, using the specified format
     ALOGV("AudioEngine::scratchPlatterActiveInternal - PlatterSample State: useEngineRate:%d, isPlaying:%d", 
-          (platterAudioSample_ ? platterAudioSample_->useEngineRateForPlayback_.load() : -1), 
-          (platterAudioSample_ ? platterAudioSample_->isPlaying.load() : -1));
+          platterControl_.useEngineRate, platterControl_.playing);
 }
 
 void AudioEngine::releasePlatterTouchInternal() {
     ALOGI("AudioEngine: releasePlatterTouchInternal");
-    isFingerDownOnPlatter_.store(false);
-    if (platterAudioSample_) {
+    std::lock_guard<std::mutex> lock(controlMutex_);
+    platterControl_.fingerDown = false;
+    if (platterVoice_) {
         // ViewModel's animation loop will now continuously call scratchPlatterActiveInternal
         // with isActiveTouch = false and the current coasting rate.
         // The isPlaying state will be managed by those calls.
-        // We ensure useEngineRateForPlayback_ is true so AudioSample uses the rates from platterTargetPlaybackRate_.
-        platterAudioSample_->useEngineRateForPlayback_.store(true);
-        ALOGI("AudioEngine: Finger up. ViewModel controls coasting rate. Sample will use engine rate. Current platterTargetPlaybackRate_: %.4f", platterTargetPlaybackRate_.load());
+        // We ensure useEngineRateForPlayback_ is true so the platter voice uses the rates from the platter controls.
+        platterControl_.useEngineRate = true;
+        ALOGI("AudioEngine: Finger up. ViewModel controls coasting rate. Sample will use engine rate. Current platter rate: %.4f", platterControl_.rate);
     }
+    pushCommands({platterControlCommand()});
 }
 
 oboe::DataCallbackResult AudioEngine::onAudioReady(oboe::AudioStream* stream, void* audioData, int32_t numFrames) {
@@ -838,21 +3405,42 @@ oboe::DataCallbackResult AudioEngine::onAudioReady(oboe::AudioStream* stream, vo
     const int32_t channelCount = stream->getChannelCount();
     memset(outputBuffer, 0, numFrames * channelCount * sizeof(float));
 
-    if (platterAudioSample_) {
-        float platterVol = platterFaderVolume_.load();
-        // Only apply generalMusicVolume for intro if not actively being touched AND not under engine rate control (i.e., initial normal playback of intro)
-        if (platterAudioSample_->playOnceThenLoopSilently &&
-            !platterAudioSample_->playedOnce &&
-            !isFingerDownOnPlatter_.load() &&
-            !platterAudioSample_->useEngineRateForPlayback_.load()
-                ) {
-            platterVol = generalMusicVolume_.load();
-        }
-        platterAudioSample_->getAudio(outputBuffer, numFrames, channelCount, platterVol);
+    // Every control change queued since the last callback lands before anything is rendered, so
+    // the whole block sees one consistent state.
+    const size_t applied = commandQueue_.drain([this](const EngineCommand& command) { applyCommand(command); });
+    if (applied > 0) {
+        // Nothing below reads a sample that a command just replaced, so it may be reclaimed from here
+        commandsApplied_.store(commandsApplied_.load(std::memory_order_relaxed) + applied, std::memory_order_release);
     }
 
-    if (musicAudioSample_ && musicAudioSample_->isPlaying.load()) {
-        musicAudioSample_->getAudio(outputBuffer, numFrames, channelCount, generalMusicVolume_.load());
+    // Trade the sinc kernels for Catmull-Rom while saving power or under a heavy voice load
+    int activeVoices = 0;
+    for (const Voice& voice : voices_) {
+        if (voice.active && voice.isPlaying) ++activeVoices;
+    }
+    const InterpolationMode interpolationMode = (mix_.powerSaveMode || activeVoices >= LOW_POWER_VOICE_THRESHOLD)
+                                                ? InterpolationMode::CatmullRom : InterpolationMode::Sinc;
+
+    for (Voice& voice : voices_) {
+        if (!voice.active) continue;
+        voice.setInterpolationMode(interpolationMode);
+        float volume = voice.gain;
+        if (&voice == platterVoice_) {
+            float platterVol = mix_.platterFaderVolume;
+            // Only apply generalMusicVolume for intro if not actively being touched AND not under engine rate control (i.e., initial normal playback of intro)
+            if (voice.playOnceThenLoopSilently &&
+                !voice.playedOnce &&
+                !mix_.fingerDownOnPlatter &&
+                !voice.useEngineRateForPlayback_
+                    ) {
+                platterVol = mix_.generalMusicVolume;
+            }
+            volume *= platterVol;
+        } else if (&voice == musicVoice_) {
+            if (!voice.isPlaying) continue;
+            volume *= mix_.generalMusicVolume;
+        }
+        voice.getAudio(outputBuffer, numFrames, channelCount, volume);
     }
     return oboe::DataCallbackResult::Continue;
 }
@@ -1043,4 +3631,53 @@ Java_com_example_fromscratch_MainActivity_setAudioNormalizationFactor(JNIEnv *en
         ALOGE("JNI: AudioEngine not initialized for setAudioNormalizationFactor.");
     }
 }
+
+JNIEXPORT void JNICALL
+Java_com_example_fromscratch_MainActivity_setPowerSaveMode(JNIEnv *env, jobject /* this */, jboolean enabled) {
+    ALOGI("JNI: setPowerSaveMode called with enabled: %d", enabled);
+    if (gAudioEngine) {
+        gAudioEngine->setPowerSaveModeInternal(enabled == JNI_TRUE);
+    } else {
+        ALOGE("JNI: AudioEngine not initialized for setPowerSaveMode.");
+    }
+}
+
+// Polled by Kotlin, so it does not log. target is a LoadTarget and the result a LoadState.
+JNIEXPORT jint JNICALL
+Java_com_example_fromscratch_MainActivity_getLoadState(JNIEnv *env, jobject /* this */, jint target) {
+    if (!gAudioEngine || target < 0 || target >= NUM_LOAD_TARGETS) return static_cast<jint>(LoadState::Idle);
+    return static_cast<jint>(gAudioEngine->loadState(static_cast<LoadTarget>(target)));
+}
+
+JNIEXPORT void JNICALL
+Java_com_example_fromscratch_MainActivity_setSampleCacheBudget(JNIEnv *env, jobject /* this */, jlong bytes) {
+    ALOGI("JNI: setSampleCacheBudget called with %lld bytes", static_cast<long long>(bytes));
+    if (gAudioEngine) {
+        gAudioEngine->setSampleCacheBudgetInternal(static_cast<size_t>(std::max<jlong>(bytes, 0)));
+    } else {
+        ALOGE("JNI: AudioEngine not initialized for setSampleCacheBudget.");
+    }
+}
+
+JNIEXPORT void JNICALL
+Java_com_example_fromscratch_MainActivity_setPrefetchDepth(JNIEnv *env, jobject /* this */, jint depth, jboolean includePrevious) {
+    ALOGI("JNI: setPrefetchDepth called with depth: %d, includePrevious: %d", depth, includePrevious);
+    if (gAudioEngine) {
+        gAudioEngine->setPrefetchDepthInternal(static_cast<int>(depth), includePrevious == JNI_TRUE);
+    } else {
+        ALOGE("JNI: AudioEngine not initialized for setPrefetchDepth.");
+    }
+}
+
+// [hits, misses, evictions, bytes, entries, byte budget]
+JNIEXPORT jlongArray JNICALL
+Java_com_example_fromscratch_MainActivity_getSampleCacheStats(JNIEnv *env, jobject /* this */) {
+    SampleCache::Stats stats;
+    if (gAudioEngine) stats = gAudioEngine->sampleCacheStats();
+    const jlong values[] = {static_cast<jlong>(stats.hits), static_cast<jlong>(stats.misses), static_cast<jlong>(stats.evictions),
+                            static_cast<jlong>(stats.bytes), static_cast<jlong>(stats.entries), static_cast<jlong>(stats.byteBudget)};
+    jlongArray result = env->NewLongArray(6);
+    if (result) env->SetLongArrayRegion(result, 0, 6, values);
+    return result;
+}
 } // extern "C"
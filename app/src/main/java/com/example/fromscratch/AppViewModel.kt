@@ -28,7 +28,8 @@ class AppViewModel( // This should be the only declaration of this class in this
     private val onScratchPlatterActive: (isActive: Boolean, angleDeltaOrRate: Float) -> Unit,
     private val onReleasePlatterTouch: () -> Unit,
     private val onUpdateScratchSensitivity: (sensitivity: Float) -> Unit,
-    private val onSetAudioNormalizationFactor: (degrees: Float) -> Unit // New lambda
+    private val onSetAudioNormalizationFactor: (degrees: Float) -> Unit, // New lambda
+    private val isPlatterSampleLoading: () -> Boolean = { false } // Native loads finish in the background
 ) : ViewModel() {
 
     var currentScreen by mutableStateOf<AppScreen>(AppScreen.Loading)
@@ -91,7 +92,10 @@ class AppViewModel( // This should be the only declaration of this class in this
             } else {
                 Log.e("AppViewModel", "Cannot play intro: initial sample path is empty.")
             }
-            delay(1500) // Simulate loading time
+            // The intro decodes on the native loader thread; leave the loading screen once it is in
+            while (isPlatterSampleLoading()) {
+                delay(16)
+            }
             currentScreen = AppScreen.Main
 
             // Main animation and physics loop
@@ -1,8 +1,14 @@
 package com.example.fromscratch
 
+import android.app.ActivityManager
+import android.content.BroadcastReceiver
+import android.content.Context
+import android.content.Intent
+import android.content.IntentFilter
 import android.content.pm.ActivityInfo
 import android.content.res.AssetManager
 import android.os.Bundle
+import android.os.PowerManager
 import android.util.Log
 import androidx.activity.ComponentActivity
 import androidx.activity.OnBackPressedCallback
@@ -16,6 +22,10 @@ class MainActivity : ComponentActivity() {
         var isCurrentUserPremium: Boolean = false
         const val PAYMENT_URL: String = "https://www.example.com/subscribe"
 
+        // Must match LoadTarget and LoadState in native-lib.cpp
+        const val LOAD_TARGET_PLATTER = 0
+        const val LOAD_STATE_LOADING = 1
+
         init {
             try {
                 System.loadLibrary("scratch-emulator-lib")
@@ -46,6 +56,28 @@ class MainActivity : ComponentActivity() {
     private external fun releasePlatterTouch()
     private external fun setScratchSensitivity(sensitivity: Float) 
     private external fun setAudioNormalizationFactor(degreesPerFrame: Float) // New JNI declaration
+    private external fun setPowerSaveMode(enabled: Boolean)
+    // Samples and tracks decode on a native loader thread; this reports the latest load per target
+    private external fun getLoadState(target: Int): Int
+    // Decoded samples are cached natively up to this many bytes
+    private external fun setSampleCacheBudget(bytes: Long)
+    // [hits, misses, evictions, bytes, entries, byte budget]
+    private external fun getSampleCacheStats(): LongArray
+    // How many upcoming samples/tracks to decode ahead, and whether to keep the previous one
+    private external fun setPrefetchDepth(depth: Int, includePrevious: Boolean)
+
+    // Lets the engine drop to its low-power interpolator while battery saver is on
+    private val powerSaveModeReceiver = object : BroadcastReceiver() {
+        override fun onReceive(context: Context, intent: Intent) {
+            updatePowerSaveMode()
+        }
+    }
+
+    private fun updatePowerSaveMode() {
+        val powerManager = getSystemService(Context.POWER_SERVICE) as PowerManager
+        Log.d("ScratchEmulator", "Power-save mode: ${powerManager.isPowerSaveMode}")
+        setPowerSaveMode(powerManager.isPowerSaveMode)
+    }
 
     private val appViewModel: AppViewModel by viewModels {
         AppViewModelFactory(this)
@@ -85,7 +117,8 @@ class MainActivity : ComponentActivity() {
                     onSetAudioNormalizationFactor = { degrees -> // New lambda for ViewModelFactory
                         Log.d("MainActivity", "VM -> JNI: setAudioNormalizationFactor($degrees)")
                         activity.setAudioNormalizationFactor(degrees)
-                    }
+                    },
+                    isPlatterSampleLoading = { activity.getLoadState(LOAD_TARGET_PLATTER) == LOAD_STATE_LOADING }
                 ) as T
             }
             throw IllegalArgumentException("Unknown ViewModel class")
@@ -113,6 +146,19 @@ class MainActivity : ComponentActivity() {
         initAudioEngine(assetManager) // Initializes gAudioEngine
         Log.d("ScratchEmulator", "AudioEngine object potentially initialized via JNI.")
 
+        // Let the decoded-sample cache use a quarter of the app's memory class, and only decode
+        // ahead where memory is not tight
+        val activityManager = getSystemService(Context.ACTIVITY_SERVICE) as ActivityManager
+        setSampleCacheBudget(activityManager.memoryClass * 1024L * 1024L / 4)
+        if (activityManager.isLowRamDevice) setPrefetchDepth(0, false)
+
+        registerReceiver(
+            powerSaveModeReceiver,
+            IntentFilter(PowerManager.ACTION_POWER_SAVE_MODE_CHANGED),
+            Context.RECEIVER_NOT_EXPORTED
+        )
+        updatePowerSaveMode()
+
         // ViewModel init will call onUpdateScratchSensitivity, which calls JNI setScratchSensitivity.
         // This ensures sensitivity is set in C++ before any scratching might occur.
 
@@ -128,6 +174,9 @@ class MainActivity : ComponentActivity() {
     override fun onDestroy() {
         super.onDestroy()
         Log.d("ScratchEmulator", "MainActivity onDestroy called. Releasing AudioEngine.")
+        unregisterReceiver(powerSaveModeReceiver)
+        val cacheStats = getSampleCacheStats()
+        Log.d("ScratchEmulator", "Sample cache: ${cacheStats[0]} hits, ${cacheStats[1]} misses, ${cacheStats[2]} evictions")
         stopPlayback()
         releaseAudioEngine()
         Log.d("ScratchEmulator", "AudioEngine released via JNI.")